@@ -22,6 +22,7 @@
 #include <map>
 
 #include "napi/native_api.h"
+#include "devicestatus_data_utils.h"
 
 namespace OHOS {
 namespace Msdp {
@@ -38,7 +39,8 @@ public:
 
     virtual bool On(const int32_t& eventType, napi_value handler, bool isOnce);
     virtual bool Off(const int32_t& eventType, bool isOnce);
-    virtual void OnEvent(const int32_t& eventType, size_t argc, const int32_t& value, bool isOnce);
+    virtual void OnEvent(const int32_t& eventType, size_t argc,
+        const DevicestatusDataUtils::DevicestatusData& devicestatusData, bool isOnce);
 
 protected:
     napi_env env_;
@@ -50,6 +52,9 @@ protected:
 class JsResponse {
 public:
     int32_t devicestatusValue_ = -1;
+    int64_t timestamp_ = 0;
+    int64_t sequence_ = 0;
+    int32_t sourceId_ = 0;
 };
 } // namespace Msdp
 } // namespace OHOS
@@ -53,7 +53,7 @@ public:
     static napi_value CreateInstanceForResponse(napi_env env, int32_t value);
     static void RegisterCallback(const int32_t& eventType);
     static void InvokeCallBack(napi_env env, napi_value *args, bool voidParameter, int32_t value);
-    void OnDevicestatusChangedDone(const int32_t& type, const int32_t& value, bool isOnce);
+    void OnDevicestatusChangedDone(const DevicestatusDataUtils::DevicestatusData& devicestatusData, bool isOnce);
     static DevicestatusNapi* GetDevicestatusNapi(int32_t type);
     static std::map<int32_t, sptr<IdevicestatusCallback>> callbackMap_;
     static std::map<int32_t, DevicestatusNapi*> objectMap_;
@@ -115,7 +115,8 @@ bool DevicestatusEvent::Off(const int32_t& eventType, bool isOnce)
     return true;
 }
 
-void DevicestatusEvent::OnEvent(const int32_t& eventType, size_t argc, const int32_t& value, bool isOnce)
+void DevicestatusEvent::OnEvent(const int32_t& eventType, size_t argc,
+    const DevicestatusDataUtils::DevicestatusData& devicestatusData, bool isOnce)
 {
     DEV_HILOGD(JS_NAPI, "OnEvent for %{public}d, isOnce: %{public}d", eventType, isOnce);
     napi_handle_scope scope = nullptr;
@@ -163,11 +164,20 @@ void DevicestatusEvent::OnEvent(const int32_t& eventType, size_t argc, const int
     napi_value result;
     napi_create_object(env_, &result);
     JsResponse jsResponse;
-    jsResponse.devicestatusValue_ = value;
+    jsResponse.devicestatusValue_ = devicestatusData.value;
+    jsResponse.timestamp_ = devicestatusData.timestamp;
+    jsResponse.sequence_ = static_cast<int64_t>(devicestatusData.sequence);
+    jsResponse.sourceId_ = devicestatusData.sourceId;
 
     napi_value tmpValue;
     napi_create_int32(env_, jsResponse.devicestatusValue_, &tmpValue);
     napi_set_named_property(env_, result, "devicestatusValue", tmpValue);
+    napi_create_int64(env_, jsResponse.timestamp_, &tmpValue);
+    napi_set_named_property(env_, result, "timestamp", tmpValue);
+    napi_create_int64(env_, jsResponse.sequence_, &tmpValue);
+    napi_set_named_property(env_, result, "sequence", tmpValue);
+    napi_create_int32(env_, jsResponse.sourceId_, &tmpValue);
+    napi_set_named_property(env_, result, "sourceId", tmpValue);
 
     status = napi_call_function(env_, thisVar, handler, argc, &result, &callResult);
     if (status != napi_ok) {
@@ -48,8 +48,7 @@ void DevicestatusCallback::OnDevicestatusChanged(const DevicestatusDataUtils::De
         DEV_HILOGD(JS_NAPI, "devicestatus is nullptr");
         return;
     }
-    devicestatusNapi->OnDevicestatusChangedDone(static_cast<int32_t> (devicestatusData.type),
-        static_cast<int32_t> (devicestatusData.value), false);
+    devicestatusNapi->OnDevicestatusChangedDone(devicestatusData, false);
     DEV_HILOGD(JS_NAPI, "Callback exit");
 }
 
@@ -120,10 +119,11 @@ napi_value DevicestatusNapi::CreateInstanceForResponse(napi_env env, int32_t val
     return instance;
 }
 
-void DevicestatusNapi::OnDevicestatusChangedDone(const int32_t& type, const int32_t& value, bool isOnce)
+void DevicestatusNapi::OnDevicestatusChangedDone(const DevicestatusDataUtils::DevicestatusData& devicestatusData,
+    bool isOnce)
 {
-    DEV_HILOGD(JS_NAPI, "Enter, value = %{public}d", value);
-    OnEvent(type, ARG_1, value, isOnce);
+    DEV_HILOGD(JS_NAPI, "Enter, value = %{public}d", devicestatusData.value);
+    OnEvent(devicestatusData.type, ARG_1, devicestatusData, isOnce);
     DEV_HILOGD(JS_NAPI, "Exit");
 }
 
@@ -360,7 +360,7 @@ napi_value DevicestatusNapi::GetDevicestatus(napi_env env, napi_callback_info in
     DevicestatusDataUtils::DevicestatusData devicestatusData = \
         g_DevicestatusClient.GetDevicestatusData(DevicestatusDataUtils::DevicestatusType(type));
 
-    obj->OnDevicestatusChangedDone(devicestatusData.type, devicestatusData.value, true);
+    obj->OnDevicestatusChangedDone(devicestatusData, true);
     obj->Off(devicestatusData.type, true);
 
     napi_get_undefined(env, &result);
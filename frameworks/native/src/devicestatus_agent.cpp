@@ -15,6 +15,8 @@
 
 #include "devicestatus_agent.h"
 
+#include <algorithm>
+
 #include "devicestatus_common.h"
 #include "devicestatus_client.h"
 
@@ -23,7 +25,7 @@ namespace Msdp {
 void DeviceStatusAgent::DeviceStatusAgentCallback::OnDevicestatusChanged(
     const DevicestatusDataUtils::DevicestatusData& devicestatusData)
 {
-    DEV_HILOGI(INNERKIT, "type=%{punlic}d, value=%{public}d",
+    DEV_HILOGI(INNERKIT, "type=%{public}d, value=%{public}d",
         static_cast<DevicestatusDataUtils::DevicestatusType>(devicestatusData.type),
         static_cast<DevicestatusDataUtils::DevicestatusValue>(devicestatusData.value));
     std::shared_ptr<DeviceStatusAgent> agent = agent_.lock();
@@ -31,38 +33,134 @@ void DeviceStatusAgent::DeviceStatusAgentCallback::OnDevicestatusChanged(
         DEV_HILOGE(SERVICE, "agent is nullptr");
         return;
     }
-    agent->agentEvent_->OnEventResult(devicestatusData);
+    agent->OnEvent(devicestatusData);
+}
+
+DeviceStatusAgent::~DeviceStatusAgent()
+{
+    if (callback_ == nullptr) {
+        return;
+    }
+    uint32_t typeMask = 0;
+    for (size_t i = 0; i < DEVICESTATUS_TYPE_COUNT; ++i) {
+        DevicestatusDataUtils::DevicestatusType type = DevicestatusTypeTable<int32_t>::TypeAt(i);
+        typeMask |= handlers_[type].empty() ? 0 : DevicestatusTypeMask(type);
+    }
+    if (typeMask != 0) {
+        DevicestatusTypeTable<int32_t> results;
+        DevicestatusClient::GetInstance().UnSubscribeCallback(typeMask, callback_, results);
+    }
 }
 
 int32_t DeviceStatusAgent::SubscribeAgentEvent(const DevicestatusDataUtils::DevicestatusType& type,
     const std::shared_ptr<DeviceStatusAgent::DeviceStatusAgentEvent>& agentEvent)
 {
     DEV_HILOGI(INNERKIT, "Enter");
-    RegisterServiceEvent(type);
-    if (agentEvent == nullptr) {
+    if ((agentEvent == nullptr) || !IsValidDevicestatusType(type)) {
         return ERR_INVALID_VALUE;
     }
-    agentEvent_ = agentEvent;
+    std::lock_guard<std::mutex> lock(mutex_);
+    HandlerList& handlers = handlers_[type];
+    if (std::find(handlers.begin(), handlers.end(), agentEvent) != handlers.end()) {
+        DEV_HILOGI(INNERKIT, "handler already subscribed to type: %{public}d", type);
+        return ERR_OK;
+    }
+    // Only the first handler of a type subscribes the shared callback.
+    if (handlers.empty()) {
+        int32_t ret = RegisterServiceEvent(type);
+        if (ret != ERR_OK) {
+            return ret;
+        }
+    }
+    handlers.push_back(agentEvent);
+    PublishHandlersLocked(type);
     return ERR_OK;
 }
 
 int32_t DeviceStatusAgent::UnSubscribeAgentEvent(const DevicestatusDataUtils::DevicestatusType& type)
 {
+    DEV_HILOGI(INNERKIT, "Enter");
+    if (!IsValidDevicestatusType(type)) {
+        return ERR_INVALID_VALUE;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (handlers_[type].empty()) {
+        return ERR_OK;
+    }
+    handlers_[type].clear();
+    PublishHandlersLocked(type);
     UnRegisterServiceEvent(type);
     return ERR_OK;
 }
 
-void DeviceStatusAgent::RegisterServiceEvent(const DevicestatusDataUtils::DevicestatusType& type)
+int32_t DeviceStatusAgent::UnSubscribeAgentEvent(const DevicestatusDataUtils::DevicestatusType& type,
+    const std::shared_ptr<DeviceStatusAgent::DeviceStatusAgentEvent>& agentEvent)
 {
     DEV_HILOGI(INNERKIT, "Enter");
-    callback_ = new DeviceStatusAgentCallback(shared_from_this());
-    DevicestatusClient::GetInstance().SubscribeCallback(type, callback_);
+    if (!IsValidDevicestatusType(type)) {
+        return ERR_INVALID_VALUE;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    HandlerList& handlers = handlers_[type];
+    auto iter = std::find(handlers.begin(), handlers.end(), agentEvent);
+    if (iter == handlers.end()) {
+        return E_DEVICESTATUS_NOT_SUBSCRIBED;
+    }
+    handlers.erase(iter);
+    PublishHandlersLocked(type);
+    if (handlers.empty()) {
+        UnRegisterServiceEvent(type);
+    }
+    return ERR_OK;
+}
+
+int32_t DeviceStatusAgent::RegisterServiceEvent(const DevicestatusDataUtils::DevicestatusType& type)
+{
+    DEV_HILOGI(INNERKIT, "Enter");
+    // One callback serves every type, it is created once and kept for the lifetime of the agent.
+    if (callback_ == nullptr) {
+        callback_ = new (std::nothrow) DeviceStatusAgentCallback(shared_from_this());
+        if (callback_ == nullptr) {
+            DEV_HILOGE(INNERKIT, "create agent callback failed");
+            return E_DEVICESTATUS_INNER_ERR;
+        }
+    }
+    DevicestatusTypeTable<int32_t> results(E_DEVICESTATUS_INNER_ERR);
+    int32_t ret = DevicestatusClient::GetInstance().SubscribeCallback(DevicestatusTypeMask(type), callback_, results);
+    return (ret != ERR_OK) ? ret : results[type];
 }
 
 void DeviceStatusAgent::UnRegisterServiceEvent(const DevicestatusDataUtils::DevicestatusType& type)
 {
     DEV_HILOGI(INNERKIT, "Enter");
-    DevicestatusClient::GetInstance().UnSubscribeCallback(type, callback_);
+    DEVICESTATUS_RETURN_IF(callback_ == nullptr);
+    DevicestatusTypeTable<int32_t> results;
+    DevicestatusClient::GetInstance().UnSubscribeCallback(DevicestatusTypeMask(type), callback_, results);
+}
+
+void DeviceStatusAgent::PublishHandlersLocked(const DevicestatusDataUtils::DevicestatusType& type)
+{
+    std::shared_ptr<const HandlerList> snapshot;
+    if (!handlers_[type].empty()) {
+        snapshot = std::make_shared<const HandlerList>(handlers_[type]);
+    }
+    std::atomic_store(&handlerSnapshots_[type], snapshot);
+}
+
+void DeviceStatusAgent::OnEvent(const DevicestatusDataUtils::DevicestatusData& devicestatusData)
+{
+    const std::shared_ptr<const HandlerList>* slot = handlerSnapshots_.Find(devicestatusData.type);
+    if (slot == nullptr) {
+        DEV_HILOGE(INNERKIT, "invalid type: %{public}d", devicestatusData.type);
+        return;
+    }
+    std::shared_ptr<const HandlerList> handlers = std::atomic_load(slot);
+    if (handlers == nullptr) {
+        return;
+    }
+    for (const auto& handler : *handlers) {
+        handler->OnEventResult(devicestatusData);
+    }
 }
 } // namespace Msdp
-} // namespace OHOS
\ No newline at end of file
+} // namespace OHOS
@@ -38,6 +38,11 @@ void DevicestatusCallbackProxy::OnDevicestatusChanged(const DevicestatusDataUtil
 
     DEVICESTATUS_WRITE_PARCEL_NO_RET(data, Int32, static_cast<int32_t>(devicestatusData.type));
     DEVICESTATUS_WRITE_PARCEL_NO_RET(data, Int32, static_cast<int32_t>(devicestatusData.value));
+    // Appended after the original fields so that older stubs, which stop after the value, still parse it.
+    DEVICESTATUS_WRITE_PARCEL_NO_RET(data, Int32, DevicestatusDataUtils::DATA_EXTENSION_VERSION);
+    DEVICESTATUS_WRITE_PARCEL_NO_RET(data, Int64, devicestatusData.timestamp);
+    DEVICESTATUS_WRITE_PARCEL_NO_RET(data, Uint64, devicestatusData.sequence);
+    DEVICESTATUS_WRITE_PARCEL_NO_RET(data, Int32, devicestatusData.sourceId);
 
     int32_t ret = remote->SendRequest(static_cast<int32_t>(IdevicestatusCallback::DEVICESTATUS_CHANGE),
         data, reply, option);
@@ -15,29 +15,63 @@
 
 #include "devicestatus_client.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
 #include <iservice_registry.h>
 #include <if_system_ability_manager.h>
 #include <ipc_skeleton.h>
+#include <random>
 #include <system_ability_definition.h>
 
+#include "devicestatus_backoff.h"
+
 namespace OHOS {
 namespace Msdp {
+namespace {
+// A restarted service is contacted by every client at once; spread the replays over this window.
+constexpr int32_t REPLAY_JITTER_MAX_MS = 2000;
+constexpr int64_t REPLAY_RETRY_BASE_NS = 1000000000;
+constexpr int64_t REPLAY_RETRY_MAX_NS = 60000000000;
+}
+
 DevicestatusClient::DevicestatusClient() {}
 DevicestatusClient::~DevicestatusClient()
 {
-    if (devicestatusProxy_ != nullptr) {
-        auto remoteObject = devicestatusProxy_->AsObject();
+    {
+        std::lock_guard<std::mutex> lock(replayMutex_);
+        replayStop_ = true;
+    }
+    replayCond_.notify_all();
+    if (replayThread_.joinable()) {
+        replayThread_.join();
+    }
+    if (statusListener_ != nullptr) {
+        sptr<ISystemAbilityManager> sam = SystemAbilityManagerClient::GetInstance().GetSystemAbilityManager();
+        if (sam != nullptr) {
+            sam->UnSubscribeSystemAbility(MSDP_DEVICESTATUS_SERVICE_ID, statusListener_);
+        }
+    }
+    std::shared_ptr<const sptr<Idevicestatus>> proxy = std::atomic_load(&devicestatusProxy_);
+    if (proxy != nullptr) {
+        auto remoteObject = (*proxy)->AsObject();
         if (remoteObject != nullptr) {
             remoteObject->RemoveDeathRecipient(deathRecipient_);
         }
     }
 }
 
-ErrCode DevicestatusClient::Connect()
+ErrCode DevicestatusClient::Connect(sptr<Idevicestatus>& proxy)
 {
+    std::shared_ptr<const sptr<Idevicestatus>> connected = std::atomic_load(&devicestatusProxy_);
+    if (connected != nullptr) {
+        proxy = *connected;
+        return ERR_OK;
+    }
     std::lock_guard<std::mutex> lock(mutex_);
-    if (devicestatusProxy_ != nullptr) {
-        DEV_HILOGE(INNERKIT, "devicestatusProxy_ is nut nullptr");
+    connected = std::atomic_load(&devicestatusProxy_);
+    if (connected != nullptr) {
+        proxy = *connected;
         return ERR_OK;
     }
 
@@ -53,10 +87,12 @@ ErrCode DevicestatusClient::Connect()
         return E_DEVICESTATUS_GET_SERVICE_FAILED;
     }
 
-    deathRecipient_ = sptr<IRemoteObject::DeathRecipient>(new DevicestatusDeathRecipient());
     if (deathRecipient_ == nullptr) {
-        DEV_HILOGE(INNERKIT, "Failed to create DevicestatusDeathRecipient");
-        return ERR_NO_MEMORY;
+        deathRecipient_ = sptr<IRemoteObject::DeathRecipient>(new (std::nothrow) DevicestatusDeathRecipient());
+        if (deathRecipient_ == nullptr) {
+            DEV_HILOGE(INNERKIT, "Failed to create DevicestatusDeathRecipient");
+            return ERR_NO_MEMORY;
+        }
     }
 
     if ((remoteObject_->IsProxyObject()) && (!remoteObject_->AddDeathRecipient(deathRecipient_))) {
@@ -64,21 +100,49 @@ ErrCode DevicestatusClient::Connect()
         return E_DEVICESTATUS_ADD_DEATH_RECIPIENT_FAILED;
     }
 
-    devicestatusProxy_ = iface_cast<Idevicestatus>(remoteObject_);
+    // Registered once; from then on the client learns about the service coming back instead of polling.
+    if (statusListener_ == nullptr) {
+        statusListener_ = new (std::nothrow) DevicestatusStatusListener();
+        if ((statusListener_ == nullptr) ||
+            (sam->SubscribeSystemAbility(MSDP_DEVICESTATUS_SERVICE_ID, statusListener_) != ERR_OK)) {
+            DEV_HILOGE(INNERKIT, "subscribe service status failed, subscriptions will not survive a restart");
+        }
+    }
+
+    proxy = iface_cast<Idevicestatus>(remoteObject_);
+    std::atomic_store(&devicestatusProxy_, std::make_shared<const sptr<Idevicestatus>>(proxy));
     DEV_HILOGD(INNERKIT, "Connecting DevicestatusService success");
     return ERR_OK;
 }
 
 void DevicestatusClient::ResetProxy(const wptr<IRemoteObject>& remote)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    DEVICESTATUS_RETURN_IF(devicestatusProxy_ == nullptr);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::shared_ptr<const sptr<Idevicestatus>> proxy = std::atomic_load(&devicestatusProxy_);
+        DEVICESTATUS_RETURN_IF(proxy == nullptr);
 
-    auto serviceRemote = devicestatusProxy_->AsObject();
-    if ((serviceRemote != nullptr) && (serviceRemote == remote.promote())) {
+        auto serviceRemote = (*proxy)->AsObject();
+        DEVICESTATUS_RETURN_IF((serviceRemote == nullptr) || (serviceRemote != remote.promote()));
         serviceRemote->RemoveDeathRecipient(deathRecipient_);
-        devicestatusProxy_ = nullptr;
+        std::atomic_store(&devicestatusProxy_, std::shared_ptr<const sptr<Idevicestatus>>());
+        // A restarted service numbers its events from 1 again and knows nothing of our subscriptions.
+        liveMirrorMask_.store(0);
+        mirror_.Clear();
+    }
+    for (auto& dispatched : dispatchedSequences_) {
+        dispatched.store(0);
     }
+    {
+        std::lock_guard<std::mutex> lock(listenerMutex_);
+        remoteMask_ = 0;
+    }
+    {
+        std::lock_guard<std::mutex> lock(replayMutex_);
+        replayPending_ = true;
+    }
+    // Retried until the service is back, in case its add notice came before this death notice.
+    ScheduleReplay();
 }
 
 void DevicestatusClient::DevicestatusDeathRecipient::OnRemoteDied(const wptr<IRemoteObject>& remote)
@@ -92,16 +156,156 @@ void DevicestatusClient::DevicestatusDeathRecipient::OnRemoteDied(const wptr<IRe
     DEV_HILOGD(INNERKIT, "Recv death notice");
 }
 
+void DevicestatusClient::DevicestatusStatusListener::OnAddSystemAbility(int32_t systemAbilityId,
+    const std::string& deviceId)
+{
+    DEVICESTATUS_RETURN_IF(systemAbilityId != MSDP_DEVICESTATUS_SERVICE_ID);
+    DEV_HILOGI(INNERKIT, "devicestatus service added");
+    DevicestatusClient::GetInstance().OnServiceAdded();
+}
+
+void DevicestatusClient::DevicestatusStatusListener::OnRemoveSystemAbility(int32_t systemAbilityId,
+    const std::string& deviceId)
+{
+    DEVICESTATUS_RETURN_IF(systemAbilityId != MSDP_DEVICESTATUS_SERVICE_ID);
+    DEV_HILOGI(INNERKIT, "devicestatus service removed");
+}
+
+void DevicestatusClient::OnServiceAdded()
+{
+    sptr<ISystemAbilityManager> sam = SystemAbilityManagerClient::GetInstance().GetSystemAbilityManager();
+    sptr<IRemoteObject> remote = (sam != nullptr) ? sam->CheckSystemAbility(MSDP_DEVICESTATUS_SERVICE_ID) : nullptr;
+    std::shared_ptr<const sptr<Idevicestatus>> proxy = std::atomic_load(&devicestatusProxy_);
+    if ((remote != nullptr) && (proxy != nullptr) && ((*proxy)->AsObject() != remote)) {
+        // samgr does not order this notice after the death notice of the instance we are connected to.
+        DEV_HILOGI(INNERKIT, "service restarted before its death notice arrived");
+        ResetProxy((*proxy)->AsObject());
+    }
+    {
+        std::lock_guard<std::mutex> lock(replayMutex_);
+        // A replay waiting out its backoff tries again now that the service is back.
+        replayKick_ = true;
+    }
+    replayCond_.notify_all();
+    ScheduleReplay();
+}
+
+uint32_t DevicestatusClient::GetMissingTypesLocked()
+{
+    uint32_t typeMask = 0;
+    for (size_t i = 0; i < DEVICESTATUS_TYPE_COUNT; ++i) {
+        DevicestatusDataUtils::DevicestatusType type = DevicestatusTypeTable<int32_t>::TypeAt(i);
+        typeMask |= listeners_[type].empty() ? 0 : DevicestatusTypeMask(type);
+    }
+    return typeMask & ~remoteMask_;
+}
+
+void DevicestatusClient::ScheduleReplay()
+{
+    uint32_t missingMask = 0;
+    {
+        std::lock_guard<std::mutex> lock(listenerMutex_);
+        missingMask = GetMissingTypesLocked();
+    }
+    std::lock_guard<std::mutex> lock(replayMutex_);
+    // Also called when the listener is first registered, when the service has every subscription already.
+    DEVICESTATUS_RETURN_IF((!replayPending_ && (missingMask == 0)) || replayScheduled_ || replayStop_);
+    if (replayThread_.joinable()) {
+        replayThread_.join();
+    }
+    replayScheduled_ = true;
+    replayThread_ = std::thread(&DevicestatusClient::ReplayEntry, this);
+}
+
+void DevicestatusClient::ReplayEntry()
+{
+    std::minstd_rand random(std::random_device {}());
+    std::uniform_int_distribution<int32_t> jitter(0, REPLAY_JITTER_MAX_MS);
+    DevicestatusBackoff backoff(REPLAY_RETRY_BASE_NS, REPLAY_RETRY_MAX_NS);
+    std::chrono::nanoseconds delay = std::chrono::milliseconds(jitter(random));
+    std::unique_lock<std::mutex> lock(replayMutex_);
+    replayKick_ = false;
+    while (true) {
+        if (replayCond_.wait_for(lock, delay, [this] { return replayStop_ || replayKick_; })) {
+            if (replayStop_) {
+                break;
+            }
+            // Every client is kicked at once, so the retry is spread like the first attempt.
+            replayKick_ = false;
+            delay = std::chrono::milliseconds(jitter(random));
+            continue;
+        }
+        replayPending_ = false;
+        lock.unlock();
+        bool replayed = ReplaySubscriptions();
+        lock.lock();
+        if (replayed) {
+            break;
+        }
+        replayPending_ = true;
+        delay = std::chrono::nanoseconds(backoff.Next());
+        int64_t delayMs = std::chrono::duration_cast<std::chrono::milliseconds>(delay).count();
+        DEV_HILOGE(INNERKIT, "replay subscriptions failed, attempt: %{public}u, retry in %{public}" PRId64 "ms",
+            backoff.GetFailures(), delayMs);
+    }
+    replayScheduled_ = false;
+}
+
+bool DevicestatusClient::ReplaySubscriptions()
+{
+    std::lock_guard<std::mutex> mirrorLock(mirrorMutex_);
+    std::lock_guard<std::mutex> lock(listenerMutex_);
+    uint32_t typeMask = GetMissingTypesLocked();
+    DEVICESTATUS_RETURN_IF_WITH_RET((typeMask == 0), true);
+    DEV_HILOGI(INNERKIT, "replay subscriptions, typeMask: %{public}u", typeMask);
+    // One batched transaction for every type, which also registers the event ring again.
+    DevicestatusTypeTable<int32_t> results(E_DEVICESTATUS_INVALID_TYPE);
+    int32_t ret = UpdateRemoteLocked(true, typeMask, results);
+    DEVICESTATUS_RETURN_IF_WITH_RET((ret != ERR_OK), false);
+    if ((remoteMask_ & typeMask) != typeMask) {
+        DEV_HILOGE(INNERKIT, "service refused types %{public}u on replay", typeMask & ~remoteMask_);
+    }
+
+    uint32_t mirrorMask = mirrorTypes_ & remoteMask_;
+    DEVICESTATUS_RETURN_IF_WITH_RET((mirrorMask == 0), true);
+    DevicestatusTypeTable<DevicestatusLatestState::Entry> entries;
+    if (GetAllDevicestatusData(entries, mirrorMask) != ERR_OK) {
+        DEV_HILOGE(INNERKIT, "seed state mirror failed, reads go to the service");
+        return true;
+    }
+    for (size_t i = 0; i < DEVICESTATUS_TYPE_COUNT; ++i) {
+        DevicestatusDataUtils::DevicestatusType type = DevicestatusTypeTable<int32_t>::TypeAt(i);
+        if ((mirrorMask & DevicestatusTypeMask(type)) != 0) {
+            mirror_.Store(type, entries[type].value, entries[type].timestamp, entries[type].sequence);
+        }
+    }
+    liveMirrorMask_.fetch_or(mirrorMask);
+    return true;
+}
+
+void DevicestatusClient::DevicestatusMultiplexCallback::OnDevicestatusChanged(const \
+    DevicestatusDataUtils::DevicestatusData& devicestatusData)
+{
+    DevicestatusClient::GetInstance().DispatchLocal(devicestatusData);
+}
+
+void DevicestatusClient::DevicestatusMirrorCallback::OnDevicestatusChanged(const \
+    DevicestatusDataUtils::DevicestatusData& devicestatusData)
+{
+    DevicestatusClient::GetInstance().mirror_.Store(devicestatusData.type, devicestatusData.value,
+        devicestatusData.timestamp, devicestatusData.sequence);
+}
+
 void DevicestatusClient::SubscribeCallback(const DevicestatusDataUtils::DevicestatusType& type, \
     const sptr<IdevicestatusCallback>& callback)
 {
     DEV_HILOGD(INNERKIT, "Enter");
-    DEVICESTATUS_RETURN_IF((callback == nullptr) || (Connect() != ERR_OK));
-    if (devicestatusProxy_ == nullptr) {
-        DEV_HILOGE(SERVICE, "devicestatusProxy_ is nullptr");
-        return;
+    DEVICESTATUS_RETURN_IF((callback == nullptr) || !IsValidDevicestatusType(type));
+    DevicestatusTypeTable<int32_t> results(E_DEVICESTATUS_INVALID_TYPE);
+    int32_t ret = UpdateListeners(true, DevicestatusTypeMask(type), callback, results);
+    if ((ret != ERR_OK) || (results[type] != ERR_OK)) {
+        DEV_HILOGE(INNERKIT, "subscribe type %{public}d failed, ret: %{public}d", type, results[type]);
     }
-    devicestatusProxy_->Subscribe(type, callback);
     DEV_HILOGD(INNERKIT, "Exit");
 }
 
@@ -109,13 +313,157 @@ void DevicestatusClient::UnSubscribeCallback(const DevicestatusDataUtils::Device
     const sptr<IdevicestatusCallback>& callback)
 {
     DEV_HILOGD(INNERKIT, "Enter");
-    DEVICESTATUS_RETURN_IF((callback == nullptr) || (Connect() != ERR_OK));
-    if (devicestatusProxy_ == nullptr) {
-        DEV_HILOGE(SERVICE, "devicestatusProxy_ is nullptr");
+    DEVICESTATUS_RETURN_IF((callback == nullptr) || !IsValidDevicestatusType(type));
+    DevicestatusTypeTable<int32_t> results(E_DEVICESTATUS_INVALID_TYPE);
+    UpdateListeners(false, DevicestatusTypeMask(type), callback, results);
+    DEV_HILOGD(INNERKIT, "Exit");
+}
+
+int32_t DevicestatusClient::SubscribeCallback(uint32_t typeMask, const sptr<IdevicestatusCallback>& callback,
+    DevicestatusTypeTable<int32_t>& results)
+{
+    DEV_HILOGD(INNERKIT, "Enter");
+    DEVICESTATUS_RETURN_IF_WITH_RET((callback == nullptr), E_DEVICESTATUS_INNER_ERR);
+    int32_t ret = UpdateListeners(true, typeMask, callback, results);
+    DEV_HILOGD(INNERKIT, "Exit");
+    return ret;
+}
+
+int32_t DevicestatusClient::UnSubscribeCallback(uint32_t typeMask, const sptr<IdevicestatusCallback>& callback,
+    DevicestatusTypeTable<int32_t>& results)
+{
+    DEV_HILOGD(INNERKIT, "Enter");
+    DEVICESTATUS_RETURN_IF_WITH_RET((callback == nullptr), E_DEVICESTATUS_INNER_ERR);
+    int32_t ret = UpdateListeners(false, typeMask, callback, results);
+    DEV_HILOGD(INNERKIT, "Exit");
+    return ret;
+}
+
+int32_t DevicestatusClient::UpdateListeners(bool subscribe, uint32_t typeMask,
+    const sptr<IdevicestatusCallback>& callback, DevicestatusTypeTable<int32_t>& results)
+{
+    std::lock_guard<std::mutex> lock(listenerMutex_);
+    // Only the first listener of a type and the last one leaving it change the remote subscription.
+    uint32_t remoteMask = 0;
+    for (size_t i = 0; i < DEVICESTATUS_TYPE_COUNT; ++i) {
+        DevicestatusDataUtils::DevicestatusType type = DevicestatusTypeTable<int32_t>::TypeAt(i);
+        if ((typeMask & DevicestatusTypeMask(type)) == 0) {
+            continue;
+        }
+        ListenerList& listeners = listeners_[type];
+        auto iter = std::find(listeners.begin(), listeners.end(), callback);
+        if (subscribe) {
+            results[type] = ERR_OK;
+            if (iter != listeners.end()) {
+                continue;
+            }
+            listeners.push_back(callback);
+            remoteMask |= (listeners.size() == 1) ? DevicestatusTypeMask(type) : 0;
+        } else {
+            if (iter == listeners.end()) {
+                results[type] = E_DEVICESTATUS_NOT_SUBSCRIBED;
+                continue;
+            }
+            results[type] = ERR_OK;
+            listeners.erase(iter);
+            remoteMask |= listeners.empty() ? DevicestatusTypeMask(type) : 0;
+        }
+        PublishListenersLocked(type);
+    }
+    if (remoteMask == 0) {
+        return ERR_OK;
+    }
+
+    DevicestatusTypeTable<int32_t> remoteResults(E_DEVICESTATUS_INVALID_TYPE);
+    int32_t ret = UpdateRemoteLocked(subscribe, remoteMask, remoteResults);
+    if (!subscribe) {
+        // The local listener is gone either way; events the service still sends have nobody to go to.
+        return ERR_OK;
+    }
+    for (size_t i = 0; i < DEVICESTATUS_TYPE_COUNT; ++i) {
+        DevicestatusDataUtils::DevicestatusType type = DevicestatusTypeTable<int32_t>::TypeAt(i);
+        if ((remoteMask & DevicestatusTypeMask(type)) == 0) {
+            continue;
+        }
+        int32_t status = (ret == ERR_OK) ? remoteResults[type] : ret;
+        if (status != ERR_OK) {
+            // The service refused the type, so the only listener of it would never hear anything.
+            listeners_[type].clear();
+            PublishListenersLocked(type);
+            results[type] = status;
+        }
+    }
+    return ret;
+}
+
+int32_t DevicestatusClient::UpdateRemoteLocked(bool subscribe, uint32_t typeMask,
+    DevicestatusTypeTable<int32_t>& results)
+{
+    sptr<Idevicestatus> proxy;
+    int32_t ret = Connect(proxy);
+    DEVICESTATUS_RETURN_IF_WITH_RET((ret != ERR_OK), ret);
+    if (multiplexCallback_ == nullptr) {
+        multiplexCallback_ = new (std::nothrow) DevicestatusMultiplexCallback();
+        DEVICESTATUS_RETURN_IF_WITH_RET((multiplexCallback_ == nullptr), E_DEVICESTATUS_INNER_ERR);
+    }
+
+    if (!subscribe) {
+        ret = proxy->UnSubscribeTypes(typeMask, multiplexCallback_, results);
+        remoteMask_ &= ~typeMask;
+        return ret;
+    }
+    bool firstType = (remoteMask_ == 0);
+    ret = proxy->SubscribeTypes(typeMask, multiplexCallback_, results);
+    DEVICESTATUS_RETURN_IF_WITH_RET((ret != ERR_OK), ret);
+    for (size_t i = 0; i < DEVICESTATUS_TYPE_COUNT; ++i) {
+        DevicestatusDataUtils::DevicestatusType type = DevicestatusTypeTable<int32_t>::TypeAt(i);
+        if (((typeMask & DevicestatusTypeMask(type)) != 0) && (results[type] == ERR_OK)) {
+            remoteMask_ |= DevicestatusTypeMask(type);
+        }
+    }
+    // The service drops the ring together with the last subscription, so a new subscription registers it again.
+    if (firstType && (remoteMask_ != 0) && (ringCapacity_ != 0) && (AttachRingLocked(proxy) != ERR_OK)) {
+        DEV_HILOGE(INNERKIT, "attach event ring failed, events arrive through binder");
+    }
+    return ERR_OK;
+}
+
+void DevicestatusClient::PublishListenersLocked(const DevicestatusDataUtils::DevicestatusType& type)
+{
+    std::shared_ptr<const ListenerList> snapshot;
+    if (!listeners_[type].empty()) {
+        snapshot = std::make_shared<const ListenerList>(listeners_[type]);
+    }
+    std::atomic_store(&listenerSnapshots_[type], snapshot);
+}
+
+void DevicestatusClient::DispatchLocal(const DevicestatusDataUtils::DevicestatusData& devicestatusData)
+{
+    const std::shared_ptr<const ListenerList>* slot = listenerSnapshots_.Find(devicestatusData.type);
+    if (slot == nullptr) {
+        DEV_HILOGE(INNERKIT, "invalid type: %{public}d", devicestatusData.type);
         return;
     }
-    devicestatusProxy_->UnSubscribe(type, callback);
-    DEV_HILOGD(INNERKIT, "Exit");
+    std::shared_ptr<const ListenerList> listeners = std::atomic_load(slot);
+    if (listeners == nullptr) {
+        return;
+    }
+    // A service that does not number its events sends 0, which is passed through.
+    if (devicestatusData.sequence != 0) {
+        std::atomic<uint64_t>& newest = dispatchedSequences_[devicestatusData.type];
+        uint64_t dispatched = newest.load();
+        do {
+            if (devicestatusData.sequence <= dispatched) {
+                DEV_HILOGD(INNERKIT, "drop stale event, type: %{public}d, sequence: %{public}" PRIu64,
+                    devicestatusData.type, devicestatusData.sequence);
+                return;
+            }
+        } while (!newest.compare_exchange_weak(dispatched, devicestatusData.sequence));
+    }
+    // No lock is held here: a slow listener delays no other type and may call back into the client.
+    for (const auto& listener : *listeners) {
+        listener->OnDevicestatusChanged(devicestatusData);
+    }
 }
 
 DevicestatusDataUtils::DevicestatusData DevicestatusClient::GetDevicestatusData(const \
@@ -126,14 +474,160 @@ DevicestatusDataUtils::DevicestatusData DevicestatusClient::GetDevicestatusData(
     devicestatusData.type = DevicestatusDataUtils::DevicestatusType::TYPE_INVALID;
     devicestatusData.value = DevicestatusDataUtils::DevicestatusValue::VALUE_INVALID;
 
-    DEVICESTATUS_RETURN_IF_WITH_RET((Connect() != ERR_OK), devicestatusData);
-    if (devicestatusProxy_ == nullptr) {
-        DEV_HILOGE(SERVICE, "devicestatusProxy_ is nullptr");
+    DevicestatusStateMirror::Entry entry;
+    if (ReadMirroredState(type, entry)) {
+        devicestatusData.type = type;
+        devicestatusData.value = entry.value;
+        devicestatusData.timestamp = entry.timestamp;
+        devicestatusData.sequence = entry.sequence;
         return devicestatusData;
     }
-    devicestatusData = devicestatusProxy_->GetCache(type);
+    sptr<Idevicestatus> proxy;
+    DEVICESTATUS_RETURN_IF_WITH_RET((Connect(proxy) != ERR_OK), devicestatusData);
+    devicestatusData = proxy->GetCache(type);
     DEV_HILOGD(INNERKIT, "Exit");
     return devicestatusData;
 }
+
+int32_t DevicestatusClient::GetAllDevicestatusData(DevicestatusTypeTable<DevicestatusLatestState::Entry>& entries,
+    uint32_t typeMask)
+{
+    DEV_HILOGD(INNERKIT, "Enter");
+    sptr<Idevicestatus> proxy;
+    int32_t ret = Connect(proxy);
+    DEVICESTATUS_RETURN_IF_WITH_RET((ret != ERR_OK), ret);
+    ret = proxy->GetSnapshot(typeMask, entries);
+    DEV_HILOGD(INNERKIT, "Exit");
+    return ret;
+}
+
+int32_t DevicestatusClient::EnableEventRing(uint32_t capacity)
+{
+    DEV_HILOGD(INNERKIT, "Enter");
+    DEVICESTATUS_RETURN_IF_WITH_RET(!DevicestatusEventRing::IsValidCapacity(capacity), E_DEVICESTATUS_INNER_ERR);
+    std::lock_guard<std::mutex> lock(listenerMutex_);
+    if (ringCapacity_ != 0) {
+        DEV_HILOGI(INNERKIT, "event ring already enabled");
+        return ERR_OK;
+    }
+    ringCapacity_ = capacity;
+    // Without a remote subscription the ring is registered together with the first one.
+    int32_t ret = ERR_OK;
+    sptr<Idevicestatus> proxy;
+    if ((remoteMask_ != 0) && ((ret = Connect(proxy)) == ERR_OK)) {
+        ret = AttachRingLocked(proxy);
+    }
+    DEV_HILOGD(INNERKIT, "Exit");
+    return ret;
+}
+
+void DevicestatusClient::DisableEventRing()
+{
+    DEV_HILOGD(INNERKIT, "Enter");
+    std::unique_ptr<DevicestatusRingReader> reader;
+    {
+        std::lock_guard<std::mutex> lock(listenerMutex_);
+        ringCapacity_ = 0;
+        reader = std::move(ringReader_);
+        // Switch the service back to binder before the reader goes away, or events would pile up unread.
+        sptr<Idevicestatus> proxy;
+        if ((reader != nullptr) && (remoteMask_ != 0) && (Connect(proxy) == ERR_OK)) {
+            int32_t ret = proxy->UnregisterEventRing(multiplexCallback_);
+            if (ret != ERR_OK) {
+                DEV_HILOGE(INNERKIT, "unregister event ring failed, ret: %{public}d", ret);
+            }
+        }
+    }
+    if (reader != nullptr) {
+        reader->Stop();
+    }
+    DEV_HILOGD(INNERKIT, "Exit");
+}
+
+int32_t DevicestatusClient::EnableStateMirror(uint32_t typeMask)
+{
+    DEV_HILOGD(INNERKIT, "Enter, typeMask: %{public}u", typeMask);
+    typeMask &= DEVICESTATUS_TYPE_MASK_ALL;
+    DEVICESTATUS_RETURN_IF_WITH_RET((typeMask == 0), E_DEVICESTATUS_INVALID_TYPE);
+    std::lock_guard<std::mutex> lock(mirrorMutex_);
+    if (mirrorCallback_ == nullptr) {
+        mirrorCallback_ = new (std::nothrow) DevicestatusMirrorCallback();
+        DEVICESTATUS_RETURN_IF_WITH_RET((mirrorCallback_ == nullptr), E_DEVICESTATUS_INNER_ERR);
+    }
+    // Subscribe before seeding: an event that overtakes the snapshot carries a higher sequence and wins.
+    DevicestatusTypeTable<int32_t> results(E_DEVICESTATUS_INVALID_TYPE);
+    int32_t ret = UpdateListeners(true, typeMask, mirrorCallback_, results);
+    uint32_t subscribed = 0;
+    for (size_t i = 0; i < DEVICESTATUS_TYPE_COUNT; ++i) {
+        DevicestatusDataUtils::DevicestatusType type = DevicestatusTypeTable<int32_t>::TypeAt(i);
+        if (((typeMask & DevicestatusTypeMask(type)) != 0) && (results[type] == ERR_OK)) {
+            subscribed |= DevicestatusTypeMask(type);
+        }
+    }
+    if (subscribed == 0) {
+        DEV_HILOGE(INNERKIT, "subscribe mirrored types failed, ret: %{public}d", ret);
+        return (ret != ERR_OK) ? ret : E_DEVICESTATUS_INVALID_TYPE;
+    }
+    DevicestatusTypeTable<DevicestatusLatestState::Entry> entries;
+    ret = GetAllDevicestatusData(entries, subscribed);
+    if (ret != ERR_OK) {
+        DEV_HILOGE(INNERKIT, "seed state mirror failed, ret: %{public}d", ret);
+        UpdateListeners(false, subscribed & ~mirrorTypes_, mirrorCallback_, results);
+        return ret;
+    }
+    for (size_t i = 0; i < DEVICESTATUS_TYPE_COUNT; ++i) {
+        DevicestatusDataUtils::DevicestatusType type = DevicestatusTypeTable<int32_t>::TypeAt(i);
+        if ((subscribed & DevicestatusTypeMask(type)) != 0) {
+            mirror_.Store(type, entries[type].value, entries[type].timestamp, entries[type].sequence);
+        }
+    }
+    mirrorTypes_ |= subscribed;
+    liveMirrorMask_.fetch_or(subscribed);
+    if (subscribed != typeMask) {
+        DEV_HILOGW(INNERKIT, "only types %{public}u of %{public}u are mirrored", subscribed, typeMask);
+    }
+    DEV_HILOGD(INNERKIT, "Exit");
+    return ERR_OK;
+}
+
+void DevicestatusClient::DisableStateMirror()
+{
+    DEV_HILOGD(INNERKIT, "Enter");
+    std::lock_guard<std::mutex> lock(mirrorMutex_);
+    DEVICESTATUS_RETURN_IF(mirrorTypes_ == 0);
+    liveMirrorMask_.store(0);
+    DevicestatusTypeTable<int32_t> results;
+    UpdateListeners(false, mirrorTypes_, mirrorCallback_, results);
+    mirrorTypes_ = 0;
+    mirror_.Clear();
+    DEV_HILOGD(INNERKIT, "Exit");
+}
+
+bool DevicestatusClient::ReadMirroredState(const DevicestatusDataUtils::DevicestatusType& type,
+    DevicestatusStateMirror::Entry& entry) const
+{
+    if ((liveMirrorMask_.load(std::memory_order_acquire) & DevicestatusTypeMask(type)) == 0) {
+        return false;
+    }
+    return mirror_.Read(type, entry);
+}
+
+int32_t DevicestatusClient::AttachRingLocked(const sptr<Idevicestatus>& proxy)
+{
+    if (ringReader_ == nullptr) {
+        auto reader = std::make_unique<DevicestatusRingReader>(multiplexCallback_);
+        if (!reader->Init(ringCapacity_) || !reader->Start()) {
+            DEV_HILOGE(INNERKIT, "init event ring failed");
+            return E_DEVICESTATUS_INNER_ERR;
+        }
+        ringReader_ = std::move(reader);
+    }
+    int32_t ret = proxy->RegisterEventRing(multiplexCallback_, ringReader_->GetMemory(),
+        ringReader_->GetDoorbellFd());
+    if (ret != ERR_OK) {
+        DEV_HILOGE(INNERKIT, "register event ring failed, ret: %{public}d", ret);
+    }
+    return ret;
+}
 } // namespace Msdp
 } // namespace OHOS
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "devicestatus_ring_reader.h"
+
+#include <cerrno>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "devicestatus_common.h"
+
+namespace OHOS {
+namespace Msdp {
+namespace {
+const char* RING_NAME = "devicestatus_event_ring";
+constexpr nfds_t POLL_FD_COUNT = 2;
+}
+
+DevicestatusRingReader::~DevicestatusRingReader()
+{
+    Stop();
+    if (memory_ != nullptr) {
+        memory_->UnmapAshmem();
+        memory_->CloseAshmem();
+    }
+    if (doorbellFd_ >= 0) {
+        close(doorbellFd_);
+    }
+    if (stopFd_ >= 0) {
+        close(stopFd_);
+    }
+}
+
+bool DevicestatusRingReader::Init(uint32_t capacity)
+{
+    DEV_HILOGD(INNERKIT, "Enter, capacity: %{public}u", capacity);
+    if ((callback_ == nullptr) || !DevicestatusEventRing::IsValidCapacity(capacity)) {
+        DEV_HILOGE(INNERKIT, "invalid ring capacity: %{public}u", capacity);
+        return false;
+    }
+    int32_t size = static_cast<int32_t>(DevicestatusEventRing::GetSize(capacity));
+    memory_ = Ashmem::CreateAshmem(RING_NAME, size);
+    if ((memory_ == nullptr) || !memory_->MapReadAndWriteAshmem()) {
+        DEV_HILOGE(INNERKIT, "create ring memory failed");
+        return false;
+    }
+    void* base = const_cast<void*>(memory_->ReadFromAshmem(size, 0));
+    if (!ring_.Create(base, static_cast<size_t>(size), capacity)) {
+        DEV_HILOGE(INNERKIT, "format ring failed");
+        return false;
+    }
+    doorbellFd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    stopFd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if ((doorbellFd_ < 0) || (stopFd_ < 0)) {
+        DEV_HILOGE(INNERKIT, "create eventfd failed, errno: %{public}d", errno);
+        return false;
+    }
+    return true;
+}
+
+bool DevicestatusRingReader::Start()
+{
+    if (!ring_.IsValid() || thread_.joinable()) {
+        return false;
+    }
+    thread_ = std::thread(&DevicestatusRingReader::ReaderEntry, this);
+    return true;
+}
+
+void DevicestatusRingReader::Stop()
+{
+    if (!thread_.joinable()) {
+        return;
+    }
+    uint64_t one = 1;
+    if (write(stopFd_, &one, sizeof(one)) != static_cast<ssize_t>(sizeof(one))) {
+        DEV_HILOGE(INNERKIT, "wake reader failed, errno: %{public}d", errno);
+    }
+    thread_.join();
+}
+
+void DevicestatusRingReader::ReaderEntry()
+{
+    struct pollfd fds[POLL_FD_COUNT] = {
+        { doorbellFd_, POLLIN, 0 },
+        { stopFd_, POLLIN, 0 },
+    };
+    while (true) {
+        // Drain before sleeping, the service only rings when it finds this reader caught up with the ring.
+        DrainRing();
+        if (poll(fds, POLL_FD_COUNT, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            DEV_HILOGE(INNERKIT, "poll failed, errno: %{public}d", errno);
+            return;
+        }
+        if ((fds[1].revents & POLLIN) != 0) {
+            // The service has already left the ring, hand over what it wrote before that.
+            DrainRing();
+            return;
+        }
+        uint64_t count = 0;
+        if ((read(doorbellFd_, &count, sizeof(count)) < 0) && (errno != EAGAIN)) {
+            DEV_HILOGE(INNERKIT, "read doorbell failed, errno: %{public}d", errno);
+        }
+    }
+}
+
+void DevicestatusRingReader::DrainRing()
+{
+    DevicestatusDataUtils::DevicestatusData data;
+    while (ring_.Pop(data)) {
+        callback_->OnDevicestatusChanged(data);
+    }
+}
+} // namespace Msdp
+} // namespace OHOS
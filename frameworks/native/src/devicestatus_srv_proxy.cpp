@@ -113,9 +113,171 @@ DevicestatusDataUtils::DevicestatusData DevicestatusSrvProxy::GetCache(const \
     DEVICESTATUS_READ_PARCEL_WITH_RET(reply, Int32, devicestatusValue, devicestatusData);
     devicestatusData.type = DevicestatusDataUtils::DevicestatusType(devicestatusType);
     devicestatusData.value = DevicestatusDataUtils::DevicestatusValue(devicestatusValue);
+    // Older services reply with type and value only.
+    int32_t version = 0;
+    if ((reply.GetReadableBytes() >= sizeof(int32_t)) && reply.ReadInt32(version) &&
+        (version >= DevicestatusDataUtils::DATA_EXTENSION_VERSION)) {
+        DEVICESTATUS_READ_PARCEL_WITH_RET(reply, Int64, devicestatusData.timestamp, devicestatusData);
+        DEVICESTATUS_READ_PARCEL_WITH_RET(reply, Uint64, devicestatusData.sequence, devicestatusData);
+        DEVICESTATUS_READ_PARCEL_WITH_RET(reply, Int32, devicestatusData.sourceId, devicestatusData);
+    }
     DEV_HILOGD(INNERKIT, "type: %{public}d, value: %{public}d", devicestatusData.type, devicestatusData.value);
     DEV_HILOGD(INNERKIT, "Exit");
     return devicestatusData;
 }
+
+int32_t DevicestatusSrvProxy::SubscribeTypes(uint32_t typeMask, const sptr<IdevicestatusCallback>& callback,
+    DevicestatusTypeTable<int32_t>& results)
+{
+    return SendTypesRequest(Idevicestatus::DEVICESTATUS_SUBSCRIBE_TYPES, typeMask, callback, results);
+}
+
+int32_t DevicestatusSrvProxy::UnSubscribeTypes(uint32_t typeMask, const sptr<IdevicestatusCallback>& callback,
+    DevicestatusTypeTable<int32_t>& results)
+{
+    return SendTypesRequest(Idevicestatus::DEVICESTATUS_UNSUBSCRIBE_TYPES, typeMask, callback, results);
+}
+
+int32_t DevicestatusSrvProxy::SendTypesRequest(uint32_t code, uint32_t typeMask,
+    const sptr<IdevicestatusCallback>& callback, DevicestatusTypeTable<int32_t>& results)
+{
+    DEV_HILOGD(INNERKIT, "Enter");
+    sptr<IRemoteObject> remote = Remote();
+    DEVICESTATUS_RETURN_IF_WITH_RET((remote == nullptr) || (callback == nullptr), E_DEVICESTATUS_GET_SERVICE_FAILED);
+
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+
+    if (!data.WriteInterfaceToken(DevicestatusSrvProxy::GetDescriptor())) {
+        DEV_HILOGE(INNERKIT, "Write descriptor failed");
+        return E_DEVICESTATUS_WRITE_PARCEL_ERROR;
+    }
+
+    DEVICESTATUS_WRITE_PARCEL_WITH_RET(data, Uint32, typeMask, E_DEVICESTATUS_WRITE_PARCEL_ERROR);
+    DEVICESTATUS_WRITE_PARCEL_WITH_RET(data, RemoteObject, callback->AsObject(), E_DEVICESTATUS_WRITE_PARCEL_ERROR);
+
+    int32_t ret = remote->SendRequest(code, data, reply, option);
+    if (ret != ERR_OK) {
+        DEV_HILOGE(INNERKIT, "SendRequest is failed, error code: %{public}d", ret);
+        return ret;
+    }
+
+    // The reply carries one status per requested type, in type order.
+    uint32_t replyMask = 0;
+    DEVICESTATUS_READ_PARCEL_WITH_RET(reply, Uint32, replyMask, E_DEVICESTATUS_READ_PARCEL_ERROR);
+    for (size_t i = 0; i < DEVICESTATUS_TYPE_COUNT; ++i) {
+        DevicestatusDataUtils::DevicestatusType type = DevicestatusTypeTable<int32_t>::TypeAt(i);
+        if ((replyMask & DevicestatusTypeMask(type)) != 0) {
+            DEVICESTATUS_READ_PARCEL_WITH_RET(reply, Int32, results[type], E_DEVICESTATUS_READ_PARCEL_ERROR);
+        }
+    }
+    DEV_HILOGD(INNERKIT, "Exit");
+    return ERR_OK;
+}
+
+int32_t DevicestatusSrvProxy::GetSnapshot(uint32_t typeMask,
+    DevicestatusTypeTable<DevicestatusLatestState::Entry>& entries)
+{
+    DEV_HILOGD(INNERKIT, "Enter");
+    sptr<IRemoteObject> remote = Remote();
+    DEVICESTATUS_RETURN_IF_WITH_RET((remote == nullptr), E_DEVICESTATUS_GET_SERVICE_FAILED);
+
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+
+    if (!data.WriteInterfaceToken(DevicestatusSrvProxy::GetDescriptor())) {
+        DEV_HILOGE(INNERKIT, "Write descriptor failed");
+        return E_DEVICESTATUS_WRITE_PARCEL_ERROR;
+    }
+
+    DEVICESTATUS_WRITE_PARCEL_WITH_RET(data, Uint32, typeMask, E_DEVICESTATUS_WRITE_PARCEL_ERROR);
+
+    int32_t ret = remote->SendRequest(static_cast<int32_t>(Idevicestatus::DEVICESTATUS_GET_SNAPSHOT),
+        data, reply, option);
+    if (ret != ERR_OK) {
+        DEV_HILOGE(INNERKIT, "SendRequest is failed, error code: %{public}d", ret);
+        return ret;
+    }
+
+    uint32_t replyMask = 0;
+    DEVICESTATUS_READ_PARCEL_WITH_RET(reply, Uint32, replyMask, E_DEVICESTATUS_READ_PARCEL_ERROR);
+    for (size_t i = 0; i < DEVICESTATUS_TYPE_COUNT; ++i) {
+        DevicestatusDataUtils::DevicestatusType type = DevicestatusTypeTable<int32_t>::TypeAt(i);
+        if ((replyMask & DevicestatusTypeMask(type)) == 0) {
+            continue;
+        }
+        int32_t value = -1;
+        DEVICESTATUS_READ_PARCEL_WITH_RET(reply, Int32, value, E_DEVICESTATUS_READ_PARCEL_ERROR);
+        DEVICESTATUS_READ_PARCEL_WITH_RET(reply, Int64, entries[type].timestamp, E_DEVICESTATUS_READ_PARCEL_ERROR);
+        DEVICESTATUS_READ_PARCEL_WITH_RET(reply, Uint64, entries[type].sequence, E_DEVICESTATUS_READ_PARCEL_ERROR);
+        entries[type].value = DevicestatusDataUtils::DevicestatusValue(value);
+    }
+    DEV_HILOGD(INNERKIT, "Exit");
+    return ERR_OK;
+}
+
+int32_t DevicestatusSrvProxy::RegisterEventRing(const sptr<IdevicestatusCallback>& callback,
+    const sptr<Ashmem>& memory, int32_t doorbellFd)
+{
+    DEV_HILOGD(INNERKIT, "Enter");
+    sptr<IRemoteObject> remote = Remote();
+    DEVICESTATUS_RETURN_IF_WITH_RET((remote == nullptr) || (callback == nullptr) || (memory == nullptr),
+        E_DEVICESTATUS_GET_SERVICE_FAILED);
+
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+
+    if (!data.WriteInterfaceToken(DevicestatusSrvProxy::GetDescriptor())) {
+        DEV_HILOGE(INNERKIT, "Write descriptor failed");
+        return E_DEVICESTATUS_WRITE_PARCEL_ERROR;
+    }
+
+    DEVICESTATUS_WRITE_PARCEL_WITH_RET(data, RemoteObject, callback->AsObject(), E_DEVICESTATUS_WRITE_PARCEL_ERROR);
+    DEVICESTATUS_WRITE_PARCEL_WITH_RET(data, Ashmem, memory, E_DEVICESTATUS_WRITE_PARCEL_ERROR);
+    DEVICESTATUS_WRITE_PARCEL_WITH_RET(data, FileDescriptor, doorbellFd, E_DEVICESTATUS_WRITE_PARCEL_ERROR);
+
+    int32_t ret = remote->SendRequest(static_cast<int32_t>(Idevicestatus::DEVICESTATUS_REGISTER_EVENT_RING),
+        data, reply, option);
+    if (ret != ERR_OK) {
+        DEV_HILOGE(INNERKIT, "SendRequest is failed, error code: %{public}d", ret);
+        return ret;
+    }
+
+    DEVICESTATUS_READ_PARCEL_WITH_RET(reply, Int32, ret, E_DEVICESTATUS_READ_PARCEL_ERROR);
+    DEV_HILOGD(INNERKIT, "Exit");
+    return ret;
+}
+
+int32_t DevicestatusSrvProxy::UnregisterEventRing(const sptr<IdevicestatusCallback>& callback)
+{
+    DEV_HILOGD(INNERKIT, "Enter");
+    sptr<IRemoteObject> remote = Remote();
+    DEVICESTATUS_RETURN_IF_WITH_RET((remote == nullptr) || (callback == nullptr), E_DEVICESTATUS_GET_SERVICE_FAILED);
+
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+
+    if (!data.WriteInterfaceToken(DevicestatusSrvProxy::GetDescriptor())) {
+        DEV_HILOGE(INNERKIT, "Write descriptor failed");
+        return E_DEVICESTATUS_WRITE_PARCEL_ERROR;
+    }
+
+    DEVICESTATUS_WRITE_PARCEL_WITH_RET(data, RemoteObject, callback->AsObject(), E_DEVICESTATUS_WRITE_PARCEL_ERROR);
+
+    int32_t ret = remote->SendRequest(static_cast<int32_t>(Idevicestatus::DEVICESTATUS_UNREGISTER_EVENT_RING),
+        data, reply, option);
+    if (ret != ERR_OK) {
+        DEV_HILOGE(INNERKIT, "SendRequest is failed, error code: %{public}d", ret);
+        return ret;
+    }
+
+    DEVICESTATUS_READ_PARCEL_WITH_RET(reply, Int32, ret, E_DEVICESTATUS_READ_PARCEL_ERROR);
+    DEV_HILOGD(INNERKIT, "Exit");
+    return ret;
+}
 } // Msdp
 } // OHOS
@@ -17,16 +17,23 @@
 #define OHOS_MSDP_DEVICESTATUS_AGENT_H
 
 #include <memory>
+#include <mutex>
+#include <vector>
 
 #include "devicestatus_callback_stub.h"
 #include "devicestatus_data_utils.h"
+#include "devicestatus_type_table.h"
 
 namespace OHOS {
 namespace Msdp {
+/*
+ * Routes device status events to any number of handlers per type. The agent owns one callback object for
+ * every type it watches and subscribes it to a type while that type has at least one handler.
+ */
 class DeviceStatusAgent : public std::enable_shared_from_this<DeviceStatusAgent> {
 public:
     DeviceStatusAgent() {};
-    ~DeviceStatusAgent() {};
+    ~DeviceStatusAgent();
     class DeviceStatusAgentEvent {
     public:
         virtual ~DeviceStatusAgentEvent() = default;
@@ -44,13 +51,23 @@ public:
 
     int32_t SubscribeAgentEvent(const DevicestatusDataUtils::DevicestatusType& type,
         const std::shared_ptr<DeviceStatusAgent::DeviceStatusAgentEvent>& agentEvent);
+    // Removes every handler of the type.
     int32_t UnSubscribeAgentEvent(const DevicestatusDataUtils::DevicestatusType& type);
+    int32_t UnSubscribeAgentEvent(const DevicestatusDataUtils::DevicestatusType& type,
+        const std::shared_ptr<DeviceStatusAgent::DeviceStatusAgentEvent>& agentEvent);
     friend class DeviceStatusAgentCallback;
 private:
-    void RegisterServiceEvent(const DevicestatusDataUtils::DevicestatusType& type);
+    using HandlerList = std::vector<std::shared_ptr<DeviceStatusAgentEvent>>;
+
+    int32_t RegisterServiceEvent(const DevicestatusDataUtils::DevicestatusType& type);
     void UnRegisterServiceEvent(const DevicestatusDataUtils::DevicestatusType& type);
+    void PublishHandlersLocked(const DevicestatusDataUtils::DevicestatusType& type);
+    void OnEvent(const DevicestatusDataUtils::DevicestatusData& devicestatusData);
+    std::mutex mutex_;
     sptr<IdevicestatusCallback> callback_;
-    std::shared_ptr<DeviceStatusAgentEvent> agentEvent_;
+    DevicestatusTypeTable<HandlerList> handlers_;
+    // Copies of handlers_ read by the event path without taking mutex_.
+    DevicestatusTypeTable<std::shared_ptr<const HandlerList>> handlerSnapshots_;
 };
 } // namespace Msdp
 } // namespace OHOS
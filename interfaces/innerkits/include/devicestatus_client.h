@@ -16,15 +16,31 @@
 #ifndef DEVICESTATUS_CLIENT_H
 #define DEVICESTATUS_CLIENT_H
 
+#include <atomic>
+#include <condition_variable>
+#include <memory>
 #include <singleton.h>
+#include <system_ability_status_change_stub.h>
+#include <thread>
+#include <vector>
 
 #include "idevicestatus.h"
 #include "idevicestatus_callback.h"
 #include "devicestatus_data_utils.h"
+#include "devicestatus_callback_stub.h"
 #include "devicestatus_common.h"
+#include "devicestatus_ring_reader.h"
+#include "devicestatus_state_mirror.h"
 
 namespace OHOS {
 namespace Msdp {
+/*
+ * Process-wide entry to the service. Local callbacks are multiplexed onto one remote callback: the service
+ * sees a single subscription per type however many listeners the process has, and events are fanned out to
+ * the local listeners of their type. A type is subscribed remotely while it has at least one local listener.
+ * When the service dies, or samgr reports an instance other than the one the client is connected to, the
+ * client replays every subscription the service is missing, retrying with a capped backoff until it succeeds.
+ */
 class DevicestatusClient final : public DelayedRefSingleton<DevicestatusClient> {
     DECLARE_DELAYED_REF_SINGLETON(DevicestatusClient)
 
@@ -35,9 +51,47 @@ public:
         const sptr<IdevicestatusCallback>& callback);
     void UnSubscribeCallback(const DevicestatusDataUtils::DevicestatusType& type, \
         const sptr<IdevicestatusCallback>& callback);
+    // Subscribe or unsubscribe every type in typeMask in one transaction; results holds the per-type status.
+    int32_t SubscribeCallback(uint32_t typeMask, const sptr<IdevicestatusCallback>& callback,
+        DevicestatusTypeTable<int32_t>& results);
+    int32_t UnSubscribeCallback(uint32_t typeMask, const sptr<IdevicestatusCallback>& callback,
+        DevicestatusTypeTable<int32_t>& results);
     DevicestatusDataUtils::DevicestatusData GetDevicestatusData(const DevicestatusDataUtils::DevicestatusType& type);
+    // State of every type in typeMask in one round-trip; entries of types never reported have version 0.
+    int32_t GetAllDevicestatusData(DevicestatusTypeTable<DevicestatusLatestState::Entry>& entries,
+        uint32_t typeMask = DEVICESTATUS_TYPE_MASK_ALL);
+    // Moves delivery of the process to a shared memory ring read by a local thread. Events that do not fit in
+    // the ring still arrive through binder, so the capacity only trades memory for wakeups.
+    int32_t EnableEventRing(uint32_t capacity = DevicestatusEventRing::DEFAULT_CAPACITY);
+    void DisableEventRing();
+    // Keeps the state of the types in typeMask in process memory: seeded with one snapshot, then kept current by
+    // a subscription. While the mirror is live GetDevicestatusData serves those types without IPC.
+    int32_t EnableStateMirror(uint32_t typeMask = DEVICESTATUS_TYPE_MASK_ALL);
+    void DisableStateMirror();
+    // Returns false when the type is not mirrored or the mirror lost the service; entry.updateTime tells when
+    // the service last confirmed the value.
+    bool ReadMirroredState(const DevicestatusDataUtils::DevicestatusType& type,
+        DevicestatusStateMirror::Entry& entry) const;
 
 private:
+    using ListenerList = std::vector<sptr<IdevicestatusCallback>>;
+
+    // The one callback object the service knows about; forwards every event to the local listeners.
+    class DevicestatusMultiplexCallback : public DevicestatusCallbackStub {
+    public:
+        DevicestatusMultiplexCallback() = default;
+        ~DevicestatusMultiplexCallback() = default;
+        void OnDevicestatusChanged(const DevicestatusDataUtils::DevicestatusData& devicestatusData) override;
+    };
+
+    // Local listener of the mirrored types; stores every event it hears into the mirror.
+    class DevicestatusMirrorCallback : public DevicestatusCallbackStub {
+    public:
+        DevicestatusMirrorCallback() = default;
+        ~DevicestatusMirrorCallback() = default;
+        void OnDevicestatusChanged(const DevicestatusDataUtils::DevicestatusData& devicestatusData) override;
+    };
+
     class DevicestatusDeathRecipient : public IRemoteObject::DeathRecipient {
     public:
         DevicestatusDeathRecipient() = default;
@@ -47,11 +101,65 @@ private:
         DISALLOW_COPY_AND_MOVE(DevicestatusDeathRecipient);
     };
 
-    ErrCode Connect();
-    sptr<Idevicestatus> devicestatusProxy_ {nullptr};
-    sptr<IRemoteObject::DeathRecipient> deathRecipient_ {nullptr};
+    // Waits for the service to come back after its death and hands over to the subscription replay.
+    class DevicestatusStatusListener : public SystemAbilityStatusChangeStub {
+    public:
+        DevicestatusStatusListener() = default;
+        ~DevicestatusStatusListener() = default;
+        void OnAddSystemAbility(int32_t systemAbilityId, const std::string& deviceId) override;
+        void OnRemoveSystemAbility(int32_t systemAbilityId, const std::string& deviceId) override;
+    };
+
+    ErrCode Connect(sptr<Idevicestatus>& proxy);
+    int32_t UpdateListeners(bool subscribe, uint32_t typeMask, const sptr<IdevicestatusCallback>& callback,
+        DevicestatusTypeTable<int32_t>& results);
+    int32_t UpdateRemoteLocked(bool subscribe, uint32_t typeMask, DevicestatusTypeTable<int32_t>& results);
+    void PublishListenersLocked(const DevicestatusDataUtils::DevicestatusType& type);
+    void DispatchLocal(const DevicestatusDataUtils::DevicestatusData& devicestatusData);
+    int32_t AttachRingLocked(const sptr<Idevicestatus>& proxy);
     void ResetProxy(const wptr<IRemoteObject>& remote);
+    void OnServiceAdded();
+    // Types with local listeners that the service has no subscription for.
+    uint32_t GetMissingTypesLocked();
+    void ScheduleReplay();
+    void ReplayEntry();
+    bool ReplaySubscriptions();
+    // Published with atomic_store so that calls on a live connection never take mutex_.
+    std::shared_ptr<const sptr<Idevicestatus>> devicestatusProxy_;
+    sptr<IRemoteObject::DeathRecipient> deathRecipient_ {nullptr};
+    sptr<ISystemAbilityStatusChange> statusListener_ {nullptr};
+    // Serializes the slow path of Connect and the death handling.
     std::mutex mutex_;
+    // Guards the local listener tables, the remote subscription state and the ring; held across the remote
+    // call so that first-subscribe and last-unsubscribe of a type are never reordered.
+    std::mutex listenerMutex_;
+    sptr<DevicestatusMultiplexCallback> multiplexCallback_ {nullptr};
+    DevicestatusTypeTable<ListenerList> listeners_;
+    // Copies of listeners_ published for the event path, which reads them without taking listenerMutex_.
+    DevicestatusTypeTable<std::shared_ptr<const ListenerList>> listenerSnapshots_;
+    // Events reach DispatchLocal from the ring reader and from binder, which overtakes a full ring. The newest
+    // sequence handed over per type, advanced with a CAS so that an older event is dropped without a lock
+    // being held across the listener calls.
+    DevicestatusTypeTable<std::atomic<uint64_t>> dispatchedSequences_;
+    uint32_t remoteMask_ = 0;
+    uint32_t ringCapacity_ = 0;
+    std::unique_ptr<DevicestatusRingReader> ringReader_;
+    // Serializes EnableStateMirror and DisableStateMirror; never held on the event path.
+    std::mutex mirrorMutex_;
+    sptr<DevicestatusMirrorCallback> mirrorCallback_ {nullptr};
+    uint32_t mirrorTypes_ = 0;
+    // Mirrored types whose entries can be trusted, cleared when the service dies.
+    std::atomic<uint32_t> liveMirrorMask_ {0};
+    DevicestatusStateMirror mirror_;
+    // Guards the replay state below; replayPending_ is set by a death and cleared by a successful replay,
+    // replayKick_ cuts the backoff of a running replay short when the service is added again.
+    std::mutex replayMutex_;
+    std::condition_variable replayCond_;
+    std::thread replayThread_;
+    bool replayPending_ = false;
+    bool replayScheduled_ = false;
+    bool replayKick_ = false;
+    bool replayStop_ = false;
 };
 } // namespace Msdp
 } // namespace OHOS
@@ -16,6 +16,8 @@
 #ifndef DEVICESTATUS_DATA_UTILS_H
 #define DEVICESTATUS_DATA_UTILS_H
 
+#include <cstdint>
+
 namespace OHOS {
 namespace Msdp {
 class DevicestatusDataUtils {
@@ -34,9 +36,22 @@ public:
         VALUE_EXIT
     };
 
+    enum DevicestatusSourceId {
+        SOURCE_ID_UNKNOWN = 0,
+        SOURCE_ID_MSDP_ALGORITHM,
+        SOURCE_ID_SENSOR_HDI
+    };
+
+    // Version of the fields written after type and value in the callback parcel.
+    static constexpr int32_t DATA_EXTENSION_VERSION = 1;
+
     struct DevicestatusData {
         DevicestatusType type;
         DevicestatusValue value;
+        // Extension fields, left at zero when the producer or the peer does not provide them.
+        int64_t timestamp = 0; // CLOCK_BOOTTIME nanoseconds at which the source observed the change
+        uint64_t sequence = 0; // per-type sequence number assigned by the service, starting at 1
+        int32_t sourceId = SOURCE_ID_UNKNOWN;
     };
 };
 } // namespace Msdp
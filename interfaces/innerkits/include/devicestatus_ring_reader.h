@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DEVICESTATUS_RING_READER_H
+#define DEVICESTATUS_RING_READER_H
+
+#include <ashmem.h>
+#include <thread>
+#include <nocopyable.h>
+
+#include "idevicestatus_callback.h"
+#include "devicestatus_event_ring.h"
+
+namespace OHOS {
+namespace Msdp {
+/*
+ * Client end of an event ring: owns the shared memory and the doorbell eventfd, and runs one thread that
+ * sleeps on the doorbell and hands every event in the ring to the local callback.
+ */
+class DevicestatusRingReader {
+public:
+    explicit DevicestatusRingReader(const sptr<IdevicestatusCallback>& callback) : callback_(callback) {}
+    ~DevicestatusRingReader();
+    DISALLOW_COPY_AND_MOVE(DevicestatusRingReader);
+
+    bool Init(uint32_t capacity);
+    bool Start();
+    void Stop();
+    const sptr<Ashmem>& GetMemory() const
+    {
+        return memory_;
+    }
+    int32_t GetDoorbellFd() const
+    {
+        return doorbellFd_;
+    }
+
+private:
+    void ReaderEntry();
+    void DrainRing();
+
+    const sptr<IdevicestatusCallback> callback_;
+    sptr<Ashmem> memory_;
+    int32_t doorbellFd_ = -1;
+    int32_t stopFd_ = -1;
+    DevicestatusEventRing ring_;
+    std::thread thread_;
+};
+} // namespace Msdp
+} // namespace OHOS
+#endif // DEVICESTATUS_RING_READER_H
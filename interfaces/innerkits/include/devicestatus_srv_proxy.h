@@ -36,8 +36,19 @@ public:
         const sptr<IdevicestatusCallback>& callback) override;
     virtual DevicestatusDataUtils::DevicestatusData GetCache(const \
         DevicestatusDataUtils::DevicestatusType& type) override;
+    virtual int32_t SubscribeTypes(uint32_t typeMask, const sptr<IdevicestatusCallback>& callback,
+        DevicestatusTypeTable<int32_t>& results) override;
+    virtual int32_t UnSubscribeTypes(uint32_t typeMask, const sptr<IdevicestatusCallback>& callback,
+        DevicestatusTypeTable<int32_t>& results) override;
+    virtual int32_t GetSnapshot(uint32_t typeMask,
+        DevicestatusTypeTable<DevicestatusLatestState::Entry>& entries) override;
+    virtual int32_t RegisterEventRing(const sptr<IdevicestatusCallback>& callback, const sptr<Ashmem>& memory,
+        int32_t doorbellFd) override;
+    virtual int32_t UnregisterEventRing(const sptr<IdevicestatusCallback>& callback) override;
 
 private:
+    int32_t SendTypesRequest(uint32_t code, uint32_t typeMask, const sptr<IdevicestatusCallback>& callback,
+        DevicestatusTypeTable<int32_t>& results);
     static inline BrokerDelegator<DevicestatusSrvProxy> delegator_;
 };
 } // namespace Msdp
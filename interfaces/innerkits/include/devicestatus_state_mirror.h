@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DEVICESTATUS_STATE_MIRROR_H
+#define DEVICESTATUS_STATE_MIRROR_H
+
+#include <atomic>
+#include <cstdint>
+
+#include "devicestatus_common.h"
+#include "devicestatus_data_utils.h"
+#include "devicestatus_type_table.h"
+
+namespace OHOS {
+namespace Msdp {
+/*
+ * Client-side copy of the service state of every type, seeded from a snapshot and then kept current by the
+ * events of a subscription. Both carry the per-type sequence number assigned by the service, so a seed that
+ * races with a newer event never overwrites it. Each slot is a seqlock: readers copy it out without locking
+ * and retry only while the same type is being written.
+ */
+class DevicestatusStateMirror {
+public:
+    struct Entry {
+        DevicestatusDataUtils::DevicestatusValue value = DevicestatusDataUtils::DevicestatusValue::VALUE_INVALID;
+        int64_t timestamp = 0;
+        uint64_t sequence = 0;
+        // CLOCK_BOOTTIME nanoseconds at which the mirror last heard about the type from the service.
+        int64_t updateTime = 0;
+    };
+
+    // Stores the entry unless the slot already holds a newer sequence; returns whether it was stored.
+    bool Store(DevicestatusDataUtils::DevicestatusType type, DevicestatusDataUtils::DevicestatusValue value,
+        int64_t timestamp, uint64_t sequence)
+    {
+        Slot* slot = slots_.Find(type);
+        if (slot == nullptr) {
+            return false;
+        }
+        uint64_t seq = LockSlot(*slot);
+        bool stored = (sequence >= slot->sequence.load(std::memory_order_relaxed));
+        if (stored) {
+            slot->value.store(value, std::memory_order_relaxed);
+            slot->timestamp.store(timestamp, std::memory_order_relaxed);
+            slot->sequence.store(sequence, std::memory_order_relaxed);
+            slot->updateTime.store(DevicestatusGetBootTime(), std::memory_order_relaxed);
+        }
+        slot->seq.store(seq + 2, std::memory_order_release);
+        return stored;
+    }
+
+    // Returns false when the type is invalid or has not been stored since the last Clear().
+    bool Read(DevicestatusDataUtils::DevicestatusType type, Entry& entry) const
+    {
+        const Slot* slot = slots_.Find(type);
+        if (slot == nullptr) {
+            return false;
+        }
+        while (true) {
+            uint64_t begin = slot->seq.load(std::memory_order_acquire);
+            if ((begin & 1) != 0) {
+                continue;
+            }
+            entry.value = slot->value.load(std::memory_order_relaxed);
+            entry.timestamp = slot->timestamp.load(std::memory_order_relaxed);
+            entry.sequence = slot->sequence.load(std::memory_order_relaxed);
+            entry.updateTime = slot->updateTime.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot->seq.load(std::memory_order_relaxed) == begin) {
+                return entry.updateTime != 0;
+            }
+        }
+    }
+
+    // Forgets every type; needed when the service restarts, since its sequence numbers start over.
+    void Clear()
+    {
+        for (auto& slot : slots_) {
+            uint64_t seq = LockSlot(slot);
+            slot.value.store(DevicestatusDataUtils::DevicestatusValue::VALUE_INVALID, std::memory_order_relaxed);
+            slot.timestamp.store(0, std::memory_order_relaxed);
+            slot.sequence.store(0, std::memory_order_relaxed);
+            slot.updateTime.store(0, std::memory_order_relaxed);
+            slot.seq.store(seq + 2, std::memory_order_release);
+        }
+    }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> seq {0};
+        std::atomic<DevicestatusDataUtils::DevicestatusValue> value {
+            DevicestatusDataUtils::DevicestatusValue::VALUE_INVALID
+        };
+        std::atomic<int64_t> timestamp {0};
+        std::atomic<uint64_t> sequence {0};
+        std::atomic<int64_t> updateTime {0};
+    };
+
+    // Writers of the same type serialize on the odd seqlock value; returns the even value it replaced.
+    static uint64_t LockSlot(Slot& slot)
+    {
+        uint64_t seq = slot.seq.load(std::memory_order_relaxed);
+        do {
+            while ((seq & 1) != 0) {
+                seq = slot.seq.load(std::memory_order_relaxed);
+            }
+        } while (!slot.seq.compare_exchange_weak(seq, seq + 1, std::memory_order_relaxed));
+        std::atomic_thread_fence(std::memory_order_release);
+        return seq;
+    }
+
+    DevicestatusTypeTable<Slot> slots_;
+};
+} // namespace Msdp
+} // namespace OHOS
+#endif // DEVICESTATUS_STATE_MIRROR_H
@@ -16,11 +16,14 @@
 #ifndef IDEVICESTATUS_H
 #define IDEVICESTATUS_H
 
+#include <ashmem.h>
 #include <iremote_broker.h>
 
 #include "iremote_object.h"
 #include "idevicestatus_callback.h"
 #include "devicestatus_data_utils.h"
+#include "devicestatus_latest_state.h"
+#include "devicestatus_type_table.h"
 
 namespace OHOS {
 namespace Msdp {
@@ -29,7 +32,12 @@ public:
     enum {
         DEVICESTATUS_SUBSCRIBE = 0,
         DEVICESTATUS_UNSUBSCRIBE,
-        DEVICESTATUS_GETCACHE
+        DEVICESTATUS_GETCACHE,
+        DEVICESTATUS_SUBSCRIBE_TYPES,
+        DEVICESTATUS_UNSUBSCRIBE_TYPES,
+        DEVICESTATUS_GET_SNAPSHOT,
+        DEVICESTATUS_REGISTER_EVENT_RING,
+        DEVICESTATUS_UNREGISTER_EVENT_RING
     };
 
     virtual void Subscribe(const DevicestatusDataUtils::DevicestatusType& type, \
@@ -37,6 +45,19 @@ public:
     virtual void UnSubscribe(const DevicestatusDataUtils::DevicestatusType& type, \
         const sptr<IdevicestatusCallback>& callback) = 0;
     virtual DevicestatusDataUtils::DevicestatusData GetCache(const DevicestatusDataUtils::DevicestatusType& type) = 0;
+    // Subscribe or unsubscribe every type in typeMask at once; results holds the status of each requested type.
+    virtual int32_t SubscribeTypes(uint32_t typeMask, const sptr<IdevicestatusCallback>& callback,
+        DevicestatusTypeTable<int32_t>& results) = 0;
+    virtual int32_t UnSubscribeTypes(uint32_t typeMask, const sptr<IdevicestatusCallback>& callback,
+        DevicestatusTypeTable<int32_t>& results) = 0;
+    // Latest value, timestamp and version of every type in typeMask; a version of 0 means never reported.
+    virtual int32_t GetSnapshot(uint32_t typeMask, DevicestatusTypeTable<DevicestatusLatestState::Entry>& entries) = 0;
+    // Delivers the events of an already subscribed callback through a DevicestatusEventRing in memory and
+    // rings doorbellFd (an eventfd) when the ring turns non-empty, instead of one transaction per event.
+    virtual int32_t RegisterEventRing(const sptr<IdevicestatusCallback>& callback, const sptr<Ashmem>& memory,
+        int32_t doorbellFd) = 0;
+    // Returns the callback to binder delivery; events already in the ring are left for the client to read.
+    virtual int32_t UnregisterEventRing(const sptr<IdevicestatusCallback>& callback) = 0;
 
     DECLARE_INTERFACE_DESCRIPTOR(u"ohos.msdp.Idevicestatus");
 };
@@ -29,6 +29,12 @@ declare namespace devicestatus {
 
     export interface DevicestatusResponse {
         devicestatusValue: DevicestatusValue
+        /* Boot time in nanoseconds at which the change was observed, 0 when unknown. */
+        timestamp?: number
+        /* Per-type sequence number; a gap means intermediate changes were coalesced. */
+        sequence?: number
+        /* Producer of the change: 1 for the algorithm plugin, 2 for the sensor plugin, 0 when unknown. */
+        sourceId?: number
     }
 
     export interface HighStillResponse extends DevicestatusResponse {}
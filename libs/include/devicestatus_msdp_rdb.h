@@ -16,6 +16,7 @@
 #ifndef DEVICESTATUS_MSDP_RDB_H
 #define DEVICESTATUS_MSDP_RDB_H
 
+#include <atomic>
 #include <string>
 #include <memory>
 #include <vector>
@@ -31,36 +32,37 @@
 #include "values_bucket.h"
 #include "result_set.h"
 #include "devicestatus_data_utils.h"
+#include "devicestatus_rdb_poller.h"
+#include "devicestatus_reactor.h"
 #include "devicestatus_msdp_interface.h"
 
 namespace OHOS {
 namespace Msdp {
+/*
+ * Reads device status rows written to the MSDP stub database. Changes are picked up from inotify events on
+ * the database directory, so an idle device never wakes up for this plugin; when inotify is not available
+ * the plugin falls back to polling the database, at an interval that adapts to how often it finds changes.
+ */
 class DevicestatusMsdpRdb : public DevicestatusMsdpInterface {
 public:
-    enum EventType {
-        EVENT_UEVENT_FD,
-        EVENT_TIMER_FD,
-    };
+    static constexpr const char* DEFAULT_DATABASE_DIR = "/data";
 
-    DevicestatusMsdpRdb() {}
-    virtual ~DevicestatusMsdpRdb() {}
+    // databaseDir holds the store and is the directory watched for writes to it.
+    explicit DevicestatusMsdpRdb(const std::string& databaseDir = DEFAULT_DATABASE_DIR);
+    virtual ~DevicestatusMsdpRdb();
     bool Init();
-    void InitRdbStore();
-    void SetTimerInterval(int32_t interval);
-    void CloseTimer();
-    void InitTimer();
-    void TimerCallback();
-    int32_t RegisterTimerCallback(const int32_t fd, const EventType et);
-    void StartThread();
-    void LoopingThreadEntry();
+    void InitNotify();
+    void NotifyCallback();
+    void ChangeCallback();
+    // Asks the reactor thread to read the database; stands in for a writer the directory watch cannot see.
+    void NotifyDataChanged();
     void Enable() override;
     void Disable() override;
+    std::string Dump() override;
+    void SetLowLatency(bool lowLatency) override;
     void RegisterCallback(const std::shared_ptr<MsdpAlgorithmCallback>& callback) override;
     void UnregisterCallback() override;
-    ErrCode NotifyMsdpImpl(const DevicestatusDataUtils::DevicestatusData& data);
-    int32_t TrigerData(const std::unique_ptr<NativeRdb::ResultSet> &resultSet);
-    int32_t TrigerDatabaseObserver();
-    DevicestatusDataUtils::DevicestatusData SaveRdbData(const DevicestatusDataUtils::DevicestatusData& data);
+    ErrCode NotifyMsdpImpl(const std::vector<DevicestatusDataUtils::DevicestatusData>& batch);
     std::shared_ptr<MsdpAlgorithmCallback> GetCallbacksImpl()
     {
         std::unique_lock lock(mutex_);
@@ -68,25 +70,19 @@ public:
     }
 
 private:
-    using Callback = std::function<void(DevicestatusMsdpRdb*)>;
     std::shared_ptr<MsdpAlgorithmCallback> callbacksImpl_;
-    std::map<int32_t, Callback> callbacks_;
-    std::shared_ptr<NativeRdb::RdbStore> store_;
-    int32_t devicestatusType_ = -1;
-    int32_t devicestatusStatus_ = -1;
-    bool notifyFlag_ = false;
-    int32_t timerInterval_ = -1;
-    int32_t timerFd_ = -1;
-    int32_t epFd_ = -1;
-    std::map<DevicestatusDataUtils::DevicestatusType, DevicestatusDataUtils::DevicestatusValue> rdbDataMap_;
+    const std::string databaseDir_;
+    DevicestatusRdbPoller poller_;
+    DevicestatusReactor::Id changeId_ = DevicestatusReactor::INVALID_ID;
+    DevicestatusReactor::Id notifyId_ = DevicestatusReactor::INVALID_ID;
+    int32_t notifyFd_ = -1;
+    bool initialized_ = false;
+    // True while database changes arrive through inotify and the timer stays disarmed.
+    std::atomic<bool> pushMode_ {false};
+    std::atomic<uint64_t> changes_ {0};
+    std::atomic<uint64_t> notified_ {0};
     std::mutex mutex_;
 };
-
-class InsertOpenCallback : public NativeRdb::RdbOpenCallback {
-public:
-    int32_t OnCreate(NativeRdb::RdbStore &rdbStore) override;
-    int32_t OnUpgrade(NativeRdb::RdbStore &rdbStore, int32_t oldVersion, int32_t newVersion) override;
-};
 }
 }
 #endif // DEVICESTATUS_MSDP_RDB_H
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DEVICESTATUS_RDB_CURSOR_H
+#define DEVICESTATUS_RDB_CURSOR_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "rdb_store.h"
+#include "result_set.h"
+#include "devicestatus_data_utils.h"
+
+namespace OHOS {
+namespace Msdp {
+/*
+ * Incremental reader of the DEVICESTATUSSENSOR table shared by the RDB plugins. It remembers the ID of the
+ * last row handed out and fetches every newer row in ID order, BATCH_SIZE rows per query, so transitions
+ * written between two reads are not lost. The first read only returns the newest row, the state the writer
+ * has settled on, rather than replaying the history already in the table.
+ *
+ * The queries are constant strings with the position bound as an argument, and the column indices are
+ * resolved on the first read from a store and reused until the cursor sees a different store. The thread CPU
+ * time spent in Read() is accounted so the plugins can report the cost of a poll.
+ */
+class DevicestatusRdbCursor {
+public:
+    static constexpr int32_t BATCH_SIZE = 256;
+    static constexpr int64_t INVALID_ID = -1;
+
+    // Appends the rows past the cursor to rows in ID order and advances the cursor over them.
+    int32_t Read(NativeRdb::RdbStore& store, std::vector<DevicestatusDataUtils::DevicestatusData>& rows);
+    void Reset()
+    {
+        lastId_.store(INVALID_ID);
+    }
+    int64_t GetLastId() const
+    {
+        return lastId_.load(std::memory_order_relaxed);
+    }
+    uint64_t GetRowCount() const
+    {
+        return rowCount_.load(std::memory_order_relaxed);
+    }
+    uint64_t GetReadCount() const
+    {
+        return readCount_.load(std::memory_order_relaxed);
+    }
+    // Thread CPU time spent in Read() so far.
+    uint64_t GetReadCpuNs() const
+    {
+        return readCpuNs_.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Columns {
+        int32_t id = -1;
+        int32_t type = -1;
+        int32_t status = -1;
+    };
+
+    int32_t ReadRows(NativeRdb::RdbStore& store, std::vector<DevicestatusDataUtils::DevicestatusData>& rows);
+    int32_t ResolveColumns(NativeRdb::ResultSet& resultSet);
+    int32_t ReadBatch(NativeRdb::ResultSet& resultSet, int64_t timestamp,
+        std::vector<DevicestatusDataUtils::DevicestatusData>& rows, int32_t& count);
+
+    // Only compared against, never dereferenced: tells when the plugin reopened its store.
+    const NativeRdb::RdbStore* columnsStore_ = nullptr;
+    Columns columns_;
+    std::vector<std::string> selectionArgs_;
+    std::atomic<int64_t> lastId_ {INVALID_ID};
+    std::atomic<uint64_t> rowCount_ {0};
+    std::atomic<uint64_t> readCount_ {0};
+    std::atomic<uint64_t> readCpuNs_ {0};
+};
+} // namespace Msdp
+} // namespace OHOS
+#endif // DEVICESTATUS_RDB_CURSOR_H
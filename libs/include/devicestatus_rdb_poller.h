@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DEVICESTATUS_RDB_POLLER_H
+#define DEVICESTATUS_RDB_POLLER_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "rdb_store.h"
+#include "devicestatus_backoff.h"
+#include "devicestatus_data_utils.h"
+#include "devicestatus_poll_interval.h"
+#include "devicestatus_rdb_cursor.h"
+#include "devicestatus_reactor.h"
+#include "devicestatus_type_table.h"
+
+namespace OHOS {
+namespace Msdp {
+/*
+ * Read side of an RDB plugin: owns the store, the DevicestatusRdbCursor over it and the poll and retry timers
+ * on the shared reactor. Read() hands the rows that change the value of their type to the plugin; a store
+ * the writer has not created yet, or a read that fails, is tried again on a timer with DevicestatusBackoff.
+ * While polling, the store is read at an interval kept by DevicestatusPollInterval.
+ *
+ * Read() runs on the reactor thread only. Enable(), Disable(), the polling switches and SetLowLatency() may
+ * be called from any thread.
+ */
+class DevicestatusRdbPoller {
+public:
+    using Notify = std::function<void(const std::vector<DevicestatusDataUtils::DevicestatusData>&)>;
+
+    // name prefixes the reactor timers, databaseName is the path of the store.
+    DevicestatusRdbPoller(const std::string& name, const std::string& databaseName, const Notify& notify)
+        : name_(name), databaseName_(databaseName), notify_(notify) {}
+    ~DevicestatusRdbPoller();
+
+    // Opens the store and creates the timers; false when the timers cannot be created.
+    bool Init();
+    void Enable();
+    // Stops polling; a pending retry finds the poller disabled and does not read.
+    void Disable();
+    bool IsEnabled() const
+    {
+        return enabled_.load();
+    }
+    // Polls until StopPolling() or Disable(), starting over from the default interval; ignored while disabled.
+    void StartPolling();
+    void StopPolling();
+    void SetLowLatency(bool lowLatency);
+    int32_t Read();
+    std::string Dump() const;
+
+private:
+    static constexpr int64_t RETRY_BASE_NS = 200000000;
+    static constexpr int64_t RETRY_MAX_NS = 30000000000;
+
+    void OpenStore();
+    // Arms the poll timer once, intervalMs from now; 0 disarms it. Called with pollMutex_ held.
+    void SetTimerInterval(int32_t intervalMs);
+    void TimerCallback();
+    // Arms the retry timer after a failed read, unless a retry is already pending.
+    void ScheduleRetry();
+    void RetryCallback();
+    // Records data as the current value of its type; false when the value did not change.
+    bool SaveRdbData(const DevicestatusDataUtils::DevicestatusData& data);
+
+    const std::string name_;
+    const std::string databaseName_;
+    const Notify notify_;
+    std::shared_ptr<NativeRdb::RdbStore> store_;
+    DevicestatusRdbCursor cursor_;
+    std::vector<DevicestatusDataUtils::DevicestatusData> readRows_;
+    std::vector<DevicestatusDataUtils::DevicestatusData> changedRows_;
+    DevicestatusTypeTable<DevicestatusDataUtils::DevicestatusValue> rdbDataMap_ {
+        DevicestatusDataUtils::DevicestatusValue::VALUE_INVALID
+    };
+    DevicestatusReactor::Id timerId_ = DevicestatusReactor::INVALID_ID;
+    DevicestatusReactor::Id retryId_ = DevicestatusReactor::INVALID_ID;
+    // Used on the reactor thread only.
+    DevicestatusBackoff retryBackoff_ { RETRY_BASE_NS, RETRY_MAX_NS };
+    bool retryPending_ = false;
+    std::atomic<bool> storeOpen_ {false};
+    std::atomic<bool> enabled_ {false};
+    std::atomic<uint64_t> retries_ {0};
+    std::atomic<uint64_t> wakeups_ {0};
+    // The poll state is shared by Enable()/Disable() on binder threads and the timer on the reactor thread.
+    mutable std::mutex pollMutex_;
+    DevicestatusPollInterval pollInterval_;
+    int32_t timerInterval_ = 0;
+    bool polling_ = false;
+};
+} // namespace Msdp
+} // namespace OHOS
+#endif // DEVICESTATUS_RDB_POLLER_H
@@ -16,6 +16,7 @@
 #ifndef DEVICESTATUS_SENSOR_RDB_H
 #define DEVICESTATUS_SENSOR_RDB_H
 
+#include <atomic>
 #include <string>
 #include <memory>
 #include <vector>
@@ -33,36 +34,24 @@
 #include "sensor_agent.h"
 #include "sensor_agent_type.h"
 #include "devicestatus_data_utils.h"
+#include "devicestatus_rdb_poller.h"
 #include "devicestatus_sensor_interface.h"
 
 namespace OHOS {
 namespace Msdp {
 class DevicestatusSensorRdb : public DevicestatusSensorInterface {
 public:
-    enum EventType {
-        EVENT_UEVENT_FD,
-        EVENT_TIMER_FD,
-    };
-
-    DevicestatusSensorRdb() {}
+    DevicestatusSensorRdb();
     virtual ~DevicestatusSensorRdb() {}
     bool Init();
-    void InitRdbStore();
-    void SetTimerInterval(int32_t interval);
-    void CloseTimer();
-    void InitTimer();
-    void TimerCallback();
-    int32_t RegisterTimerCallback(const int32_t fd, const EventType et);
-    void StartThread();
-    void LoopingThreadEntry();
+    void SetLowLatency(bool lowLatency) override;
     void Enable() override;
     void Disable() override;
+    std::string Dump() override;
     void RegisterCallback(const std::shared_ptr<DevicestatusSensorHdiCallback>& callback) override;
     void UnregisterCallback() override;
     ErrCode NotifyMsdpImpl(const DevicestatusDataUtils::DevicestatusData& data);
-    int32_t TrigerData(const std::unique_ptr<NativeRdb::ResultSet> &resultSet);
-    int32_t TrigerDatabaseObserver();
-    DevicestatusDataUtils::DevicestatusData SaveRdbData(const DevicestatusDataUtils::DevicestatusData& data);
+    ErrCode NotifyMsdpImpl(const std::vector<DevicestatusDataUtils::DevicestatusData>& batch);
     std::shared_ptr<DevicestatusSensorHdiCallback> GetCallbacksImpl()
     {
         std::unique_lock lock(mutex_);
@@ -73,26 +62,13 @@ public:
     void UnSubscribeHallSensor();
 
 private:
-    using Callback = std::function<void(DevicestatusSensorRdb*)>;
     std::shared_ptr<DevicestatusSensorHdiCallback> callbacksImpl_;
-    std::map<int32_t, Callback> callbacks_;
-    std::shared_ptr<NativeRdb::RdbStore> store_;
-    int32_t devicestatusType_ = -1;
-    int32_t devicestatusStatus_ = -1;
-    bool notifyFlag_ = false;
-    int32_t timerInterval_ = -1;
+    DevicestatusRdbPoller poller_;
     int32_t curLidStatus = -1;
-    int32_t timerFd_ = -1;
-    int32_t epFd_ = -1;
-    std::map<DevicestatusDataUtils::DevicestatusType, DevicestatusDataUtils::DevicestatusValue> rdbDataMap_;
+    bool initialized_ = false;
+    std::atomic<uint64_t> notified_ {0};
     std::mutex mutex_;
 };
-
-class HelperCallback : public NativeRdb::RdbOpenCallback {
-public:
-    int32_t OnCreate(NativeRdb::RdbStore &rdbStore) override;
-    int32_t OnUpgrade(NativeRdb::RdbStore &rdbStore, int32_t oldVersion, int32_t newVersion) override;
-};
 }
 }
 #endif // DEVICESTATUS_SENSOR_RDB_H
@@ -19,6 +19,7 @@
 #include <string>
 #include <memory>
 #include <map>
+#include <vector>
 #include <errors.h>
 
 #include "devicestatus_data_utils.h"
@@ -34,12 +35,27 @@ public:
         MsdpAlgorithmCallback() = default;
         virtual ~MsdpAlgorithmCallback() = default;
         virtual void OnResult(const DevicestatusDataUtils::DevicestatusData& data) = 0;
+        // Results read together, oldest first; plugins that read in bulk report each read with one call.
+        virtual void OnResultBatch(const std::vector<DevicestatusDataUtils::DevicestatusData>& batch)
+        {
+            for (const auto& data : batch) {
+                OnResult(data);
+            }
+        }
     };
 
     virtual void RegisterCallback(const std::shared_ptr<MsdpAlgorithmCallback>& callback) = 0;
     virtual void UnregisterCallback() = 0;
     virtual void Enable() = 0;
     virtual void Disable() = 0;
+    // Human readable runtime counters for the service dump, empty when the plugin has none.
+    virtual std::string Dump()
+    {
+        return "";
+    }
+    // Set while a subscriber that wants events as early as possible needs this source; polling plugins
+    // then keep their interval short instead of backing off.
+    virtual void SetLowLatency(bool lowLatency) {}
 };
 
 struct MsdpAlgorithmHandle {
@@ -17,40 +17,80 @@
 
 #include <string>
 #include <cerrno>
-#include <sys/epoll.h>
-#include <sys/timerfd.h>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <sys/inotify.h>
 #include <unistd.h>
 #include <linux/netlink.h>
 
 #include "dummy_values_bucket.h"
 #include "devicestatus_common.h"
+#include "devicestatus_reactor.h"
 
 using namespace OHOS::NativeRdb;
 namespace OHOS {
 namespace Msdp {
 namespace {
-const std::string DATABASE_NAME = "/data/MsdpStub.db";
-constexpr int32_t TIMER_INTERVAL = 3;
+const std::string DATABASE_FILE = "MsdpStub.db";
+// Files whose changes mean new rows; the -shm index also changes on reads and is left out.
+const std::string DATABASE_FILES[] = { DATABASE_FILE, DATABASE_FILE + "-wal", DATABASE_FILE + "-journal" };
+constexpr uint32_t NOTIFY_MASK = IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE | IN_MOVED_TO;
+constexpr size_t NOTIFY_BUFFER_SIZE = 4096;
 constexpr int32_t ERR_INVALID_FD = -1;
-constexpr int32_t READ_RDB_WAIT_TIME = 30;
 std::unique_ptr<DevicestatusMsdpRdb> g_msdpRdb = std::make_unique<DevicestatusMsdpRdb>();
 constexpr int32_t ERR_NG = -1;
+constexpr size_t DUMP_BUFFER_SIZE = 128;
 DevicestatusMsdpRdb* g_rdb;
 }
 
+DevicestatusMsdpRdb::DevicestatusMsdpRdb(const std::string& databaseDir)
+    : databaseDir_(databaseDir), poller_("msdp_rdb", databaseDir + "/" + DATABASE_FILE,
+        [this](const std::vector<DevicestatusDataUtils::DevicestatusData>& batch) { NotifyMsdpImpl(batch); })
+{
+}
+
+DevicestatusMsdpRdb::~DevicestatusMsdpRdb()
+{
+    // The reactor outlives the plugin library, none of these callbacks may run after this.
+    DevicestatusReactor::GetInstance().Remove(notifyId_);
+    DevicestatusReactor::GetInstance().Remove(changeId_);
+    if (notifyFd_ != ERR_INVALID_FD) {
+        close(notifyFd_);
+    }
+}
+
 bool DevicestatusMsdpRdb::Init()
 {
     DEV_HILOGI(SERVICE, "DevicestatusMsdpRdbInit: Enter");
-    InitRdbStore();
-    InitTimer();
-    StartThread();
+    if (initialized_) {
+        // The registrations outlive Disable(); catch up on what changed while disabled.
+        poller_.Enable();
+        if (pushMode_.load()) {
+            NotifyDataChanged();
+        } else {
+            poller_.StartPolling();
+        }
+        return true;
+    }
+    if (!poller_.Init()) {
+        DEV_HILOGE(SERVICE, "init poller failed");
+        return false;
+    }
+    InitNotify();
+    poller_.Enable();
+    if (pushMode_.load()) {
+        // Nothing to poll for; read the rows that are already there once.
+        NotifyDataChanged();
+    } else {
+        poller_.StartPolling();
+    }
+    DevicestatusReactor::GetInstance().Start();
+    initialized_ = true;
     DEV_HILOGI(SERVICE, "DevicestatusMsdpRdbInit: Exit");
     return true;
 }
 
-void DevicestatusMsdpRdb::InitRdbStore()
-{}
-
 void DevicestatusMsdpRdb::RegisterCallback(const std::shared_ptr<MsdpAlgorithmCallback>& callback)
 {
     callbacksImpl_ = callback;
@@ -71,278 +111,114 @@ void DevicestatusMsdpRdb::Enable()
 void DevicestatusMsdpRdb::Disable()
 {
     DEV_HILOGI(SERVICE, "Enter");
-    CloseTimer();
+    poller_.Disable();
     DEV_HILOGI(SERVICE, "Exit");
 }
 
-ErrCode DevicestatusMsdpRdb::NotifyMsdpImpl(const DevicestatusDataUtils::DevicestatusData& data)
+std::string DevicestatusMsdpRdb::Dump()
 {
-    DEV_HILOGI(SERVICE, "Enter");
-    if (g_rdb == nullptr) {
-        DEV_HILOGE(SERVICE, "g_rdb is nullptr");
-        return ERR_NG;
-    }
-    if (g_rdb->GetCallbacksImpl() == nullptr) {
-        DEV_HILOGI(SERVICE, "callbacksImpl is nullptr");
-        return ERR_NG;
-    }
-    g_rdb->GetCallbacksImpl()->OnResult(data);
-
-    return ERR_OK;
-}
-
-DevicestatusDataUtils::DevicestatusData DevicestatusMsdpRdb::SaveRdbData(
-    const DevicestatusDataUtils::DevicestatusData& data)
-{
-    for (auto iter = rdbDataMap_.begin(); iter != rdbDataMap_.end(); ++iter) {
-        if (iter->first == data.type) {
-            if (iter->second != data.value) {
-                notifyFlag_ = true;
-                iter->second = data.value;
-            }
-            DEV_HILOGI(SERVICE, "data is not changed");
-            return data;
-        }
-    }
-
-    rdbDataMap_.insert(std::make_pair(data.type, data.value));
-    notifyFlag_ = true;
-
-    DEV_HILOGI(SERVICE, "devicestatusType_ = %{public}d, devicestatusStatus_ = %{public}d",
-        devicestatusType_, devicestatusStatus_);
-
-    return data;
+    char buf[DUMP_BUFFER_SIZE];
+    int32_t len = snprintf(buf, sizeof(buf), "mode=%s changes=%" PRIu64 " notified=%" PRIu64 " ",
+        pushMode_.load() ? "push" : "poll", changes_.load(std::memory_order_relaxed),
+        notified_.load(std::memory_order_relaxed));
+    return ((len > 0) ? std::string(buf) : std::string()) + poller_.Dump();
 }
 
-int32_t DevicestatusMsdpRdb::TrigerData(const std::unique_ptr<NativeRdb::ResultSet> &resultSet)
+ErrCode DevicestatusMsdpRdb::NotifyMsdpImpl(const std::vector<DevicestatusDataUtils::DevicestatusData>& batch)
 {
-    int32_t columnIndex;
-    int32_t intVal;
-    if (resultSet == nullptr) {
-        DEV_HILOGE(SERVICE, "resultSet is nullptr");
+    std::shared_ptr<MsdpAlgorithmCallback> callback = GetCallbacksImpl();
+    if (callback == nullptr) {
+        DEV_HILOGI(SERVICE, "callbacksImpl is nullptr");
         return ERR_NG;
     }
-    int32_t ret = resultSet->GetColumnIndex("ID", columnIndex);
-    DEV_HILOGI(SERVICE, "TrigerDatabaseObserver GetColumnIndex = %{public}d", columnIndex);
-    if (ret != ERR_OK) {
-        DEV_HILOGE(SERVICE, "CheckID: GetColumnIndex failed");
-        return -1;
-    }
-    ret = resultSet->GetInt(columnIndex, intVal);
-    DEV_HILOGI(SERVICE, "ret = %{public}d, id = %{public}d", ret, intVal);
-    if (ret != ERR_OK) {
-        DEV_HILOGE(SERVICE, "CheckID: GetValue failed");
-        return -1;
-    }
-
-    ret = resultSet->GetColumnIndex("DEVICESTATUS_TYPE", columnIndex);
-    DEV_HILOGI(SERVICE, "DEVICESTATUS_TYPE GetColumnIndex = %{public}d", columnIndex);
-    if (ret != ERR_OK) {
-        DEV_HILOGE(SERVICE, "CheckDevicestatusType: GetColumnIndex failed");
-        return -1;
-    }
-    ret = resultSet->GetInt(columnIndex, intVal);
-    DEV_HILOGI(SERVICE, "ret = %{public}d, DevicestatusType = %{public}d", ret, intVal);
-    devicestatusType_ = intVal;
-    if (ret != ERR_OK) {
-        DEV_HILOGE(SERVICE, "CheckDevicestatusType: GetValue failed");
-        return -1;
-    }
-
-    ret = resultSet->GetColumnIndex("DEVICESTATUS_STATUS", columnIndex);
-    DEV_HILOGI(SERVICE, "DEVICESTATUS_STATUS GetColumnIndex = %{public}d", columnIndex);
-    if (ret != ERR_OK) {
-        DEV_HILOGE(SERVICE, "CheckDevicestatusStatus: GetColumnIndex failed");
-        return -1;
-    }
-    ret = resultSet->GetInt(columnIndex, intVal);
-    DEV_HILOGI(SERVICE, "ret = %{public}d, DevicestatusStatus = %{public}d", ret, intVal);
-    devicestatusStatus_ = intVal;
-    if (ret != ERR_OK) {
-        DEV_HILOGE(SERVICE, "CheckDevicestatusStatus: GetValue failed");
-        return -1;
-    }
-
+    callback->OnResultBatch(batch);
+    notified_.fetch_add(batch.size(), std::memory_order_relaxed);
     return ERR_OK;
 }
 
-int32_t DevicestatusMsdpRdb::TrigerDatabaseObserver()
+void DevicestatusMsdpRdb::SetLowLatency(bool lowLatency)
 {
-    DEV_HILOGI(SERVICE, "Enter");
-
-    if (store_ == nullptr) {
-        sleep(READ_RDB_WAIT_TIME);
-        InitRdbStore();
-        return -1;
-    }
-
-    std::unique_ptr<ResultSet> resultSet =
-        store_->QuerySql("SELECT * FROM DEVICESTATUSSENSOR WHERE ID = (SELECT max(ID) from DEVICESTATUSSENSOR)");
-
-    if (resultSet == nullptr) {
-        DEV_HILOGE(SERVICE, "database is not exist");
-        return -1;
-    }
-
-    int32_t ret = resultSet->GoToFirstRow();
-    DEV_HILOGI(SERVICE, "GoToFirstRow = %{public}d", ret);
-    if (ret != ERR_OK) {
-        sleep(READ_RDB_WAIT_TIME);
-        DEV_HILOGE(SERVICE, "database observer is null");
-        return -1;
-    }
-
-    if (TrigerData(resultSet) != ERR_OK) {
-        DEV_HILOGE(SERVICE, "triger data failed");
-        return -1;
-    }
-
-    ret = resultSet->Close();
-    if (ret != ERR_OK) {
-        DEV_HILOGE(SERVICE, "close database observer failed");
-        return -1;
-    }
-
-    DevicestatusDataUtils::DevicestatusData data;
-    data.type = (DevicestatusDataUtils::DevicestatusType)devicestatusType_;
-    data.value = (DevicestatusDataUtils::DevicestatusValue)devicestatusStatus_;
-
-    SaveRdbData(data);
-    DEV_HILOGI(SERVICE, "notifyFlag_ is %{public}d", notifyFlag_);
-    if (notifyFlag_) {
-        NotifyMsdpImpl(data);
-        notifyFlag_ = false;
-    }
-
-    return ERR_OK;
+    poller_.SetLowLatency(lowLatency);
 }
 
-void DevicestatusMsdpRdb::InitTimer()
+void DevicestatusMsdpRdb::InitNotify()
 {
     DEV_HILOGI(SERVICE, "Enter");
-    epFd_ = epoll_create1(EPOLL_CLOEXEC);
-    if (epFd_ == -1) {
-        DEV_HILOGI(SERVICE, "create epoll fd failed");
+    changeId_ = DevicestatusReactor::GetInstance().AddTimer("msdp_rdb.change", [this] { ChangeCallback(); });
+    notifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (notifyFd_ == ERR_INVALID_FD) {
+        DEV_HILOGE(SERVICE, "inotify init failed, errno: %{public}d, poll the database", errno);
         return;
     }
-    timerFd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
-    if (timerFd_ == ERR_INVALID_FD) {
-        DEV_HILOGI(SERVICE, "create timer fd failed");
+    // The directory rather than the files: the WAL and journal come and go, and the store may not exist yet.
+    if (inotify_add_watch(notifyFd_, databaseDir_.c_str(), NOTIFY_MASK) < 0) {
+        DEV_HILOGE(SERVICE, "watch %{public}s failed, errno: %{public}d, poll the database",
+            databaseDir_.c_str(), errno);
+        close(notifyFd_);
+        notifyFd_ = ERR_INVALID_FD;
         return;
     }
-    SetTimerInterval(TIMER_INTERVAL);
-    fcntl(timerFd_, F_SETFL, O_NONBLOCK);
-    callbacks_.insert(std::make_pair(timerFd_, &DevicestatusMsdpRdb::TimerCallback));
-    if (RegisterTimerCallback(timerFd_, EVENT_TIMER_FD)) {
-        DEV_HILOGI(SERVICE, "register timer fd failed");
+    notifyId_ = DevicestatusReactor::GetInstance().AddFd(notifyFd_, "msdp_rdb.inotify",
+        [this](uint32_t) { NotifyCallback(); });
+    if (notifyId_ == DevicestatusReactor::INVALID_ID) {
+        close(notifyFd_);
+        notifyFd_ = ERR_INVALID_FD;
         return;
     }
+    pushMode_.store(true);
 }
 
-void DevicestatusMsdpRdb::SetTimerInterval(int32_t interval)
+void DevicestatusMsdpRdb::NotifyCallback()
 {
-    struct itimerspec itval;
-
-    if (timerFd_ == ERR_INVALID_FD) {
-        DEV_HILOGI(SERVICE, "create timer fd failed");
-        return;
+    alignas(struct inotify_event) char buf[NOTIFY_BUFFER_SIZE];
+    bool changed = false;
+    bool lost = false;
+    ssize_t len;
+    // Drain everything queued so that a burst of writes costs one query.
+    while ((len = read(notifyFd_, buf, sizeof(buf))) > 0) {
+        for (char* ptr = buf; ptr < buf + len;) {
+            const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(ptr);
+            ptr += sizeof(struct inotify_event) + event->len;
+            if ((event->mask & IN_Q_OVERFLOW) != 0) {
+                changed = true;
+            }
+            if ((event->mask & IN_IGNORED) != 0) {
+                lost = true;
+            }
+            if (event->len == 0) {
+                continue;
+            }
+            for (const auto& file : DATABASE_FILES) {
+                changed = changed || (strcmp(event->name, file.c_str()) == 0);
+            }
+        }
     }
-
-    timerInterval_ = interval;
-
-    if (interval < 0) {
-        interval = 0;
+    if (lost) {
+        DEV_HILOGE(SERVICE, "database directory watch removed, poll the database");
+        pushMode_.store(false);
+        poller_.StartPolling();
     }
-
-    itval.it_interval.tv_sec = interval;
-    itval.it_interval.tv_nsec = 0;
-    itval.it_value.tv_sec = interval;
-    itval.it_value.tv_nsec = 0;
-
-    if (timerfd_settime(timerFd_, 0, &itval, nullptr) == -1) {
-        DEV_HILOGI(SERVICE, "set timer failed");
-        return;
-    }
-
-    return;
-}
-
-void DevicestatusMsdpRdb::CloseTimer()
-{
-    DEV_HILOGI(SERVICE, "Enter");
-    close(timerFd_);
-    DEV_HILOGI(SERVICE, "Exit");
-}
-
-void DevicestatusMsdpRdb::TimerCallback()
-{
-    unsigned long long timers;
-    if (read(timerFd_, &timers, sizeof(timers)) == -1) {
-        DEV_HILOGI(SERVICE, "read timer fd failed");
-        return;
+    if (changed && poller_.IsEnabled()) {
+        changes_.fetch_add(1, std::memory_order_relaxed);
+        poller_.Read();
     }
-    TrigerDatabaseObserver();
 }
 
-int32_t DevicestatusMsdpRdb::RegisterTimerCallback(const int32_t fd, const EventType et)
+void DevicestatusMsdpRdb::ChangeCallback()
 {
-    DEV_HILOGI(SERVICE, "Enter");
-    struct epoll_event ev;
-
-    ev.events = EPOLLIN;
-    if (et == EVENT_TIMER_FD) {
-        ev.events |= EPOLLWAKEUP;
+    if (poller_.IsEnabled()) {
+        changes_.fetch_add(1, std::memory_order_relaxed);
+        poller_.Read();
     }
-
-    ev.data.ptr = reinterpret_cast<void*>(this);
-    ev.data.fd = fd;
-    if (epoll_ctl(epFd_, EPOLL_CTL_ADD, fd, &ev) == -1) {
-        DEV_HILOGI(SERVICE, "epoll_ctl failed, error num =%{public}d", errno);
-        return -1;
-    }
-
-    return 0;
 }
 
-void DevicestatusMsdpRdb::StartThread()
+void DevicestatusMsdpRdb::NotifyDataChanged()
 {
-    DEV_HILOGI(SERVICE, "Enter");
-    std::make_unique<std::thread>(&DevicestatusMsdpRdb::LoopingThreadEntry, this)->detach();
-}
-
-void DevicestatusMsdpRdb::LoopingThreadEntry()
-{
-    size_t cbct = callbacks_.size();
-    struct epoll_event events[cbct];
-
-    while (true) {
-        int32_t timeout = -1;
-
-        int32_t nevents = epoll_wait(epFd_, events, cbct, timeout);
-        if (nevents == -1) {
-            continue;
-        }
-        for (int32_t n = 0; n < nevents; ++n) {
-            if (events[n].data.ptr) {
-                DevicestatusMsdpRdb *func = const_cast<DevicestatusMsdpRdb *>(this);
-                (callbacks_.find(events[n].data.fd)->second)(func);
-            }
-        }
+    if (!DevicestatusReactor::GetInstance().ArmTimer(changeId_, 0)) {
+        DEV_HILOGE(SERVICE, "signal data change failed");
     }
 }
 
-int32_t InsertOpenCallback::OnCreate(RdbStore &store)
-{
-    DEV_HILOGI(SERVICE, "Enter");
-    return ERR_OK;
-}
-
-int32_t InsertOpenCallback::OnUpgrade(RdbStore &store, int32_t oldVersion, int32_t newVersion)
-{
-    DEV_HILOGI(SERVICE, "Enter");
-    return ERR_OK;
-}
-
 extern "C" DevicestatusMsdpInterface *Create(void)
 {
     DEV_HILOGI(SERVICE, "Enter");
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "devicestatus_rdb_cursor.h"
+
+#include <cinttypes>
+#include <ctime>
+#include <string>
+
+#include "devicestatus_common.h"
+
+namespace OHOS {
+namespace Msdp {
+namespace {
+const std::string LATEST_ROW_SQL = "SELECT ID, DEVICESTATUS_TYPE, DEVICESTATUS_STATUS FROM DEVICESTATUSSENSOR "
+    "WHERE ID = (SELECT max(ID) FROM DEVICESTATUSSENSOR)";
+const std::string NEXT_ROWS_SQL = "SELECT ID, DEVICESTATUS_TYPE, DEVICESTATUS_STATUS FROM DEVICESTATUSSENSOR "
+    "WHERE ID > ? ORDER BY ID LIMIT ?";
+constexpr size_t ID_ARG = 0;
+constexpr size_t LIMIT_ARG = 1;
+constexpr size_t SELECTION_ARG_COUNT = 2;
+constexpr int32_t ERR_NG = -1;
+
+int64_t GetThreadCpuTime()
+{
+    constexpr int64_t NS_PER_SECOND = 1000000000;
+    struct timespec ts = {0, 0};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * NS_PER_SECOND + ts.tv_nsec;
+}
+}
+
+int32_t DevicestatusRdbCursor::Read(NativeRdb::RdbStore& store,
+    std::vector<DevicestatusDataUtils::DevicestatusData>& rows)
+{
+    int64_t start = GetThreadCpuTime();
+    int32_t ret = ReadRows(store, rows);
+    readCount_.fetch_add(1, std::memory_order_relaxed);
+    readCpuNs_.fetch_add(static_cast<uint64_t>(GetThreadCpuTime() - start), std::memory_order_relaxed);
+    return ret;
+}
+
+int32_t DevicestatusRdbCursor::ReadRows(NativeRdb::RdbStore& store,
+    std::vector<DevicestatusDataUtils::DevicestatusData>& rows)
+{
+    if (columnsStore_ != &store) {
+        columnsStore_ = nullptr;
+        selectionArgs_.assign(SELECTION_ARG_COUNT, std::string());
+        selectionArgs_[LIMIT_ARG] = std::to_string(BATCH_SIZE);
+    }
+    // Rows become visible together, so they share the time they were read at.
+    int64_t timestamp = DevicestatusGetBootTime();
+    int32_t count = 0;
+    do {
+        int64_t lastId = lastId_.load();
+        std::unique_ptr<NativeRdb::ResultSet> resultSet;
+        if (lastId == INVALID_ID) {
+            resultSet = store.QuerySql(LATEST_ROW_SQL);
+        } else {
+            selectionArgs_[ID_ARG] = std::to_string(lastId);
+            resultSet = store.QuerySql(NEXT_ROWS_SQL, selectionArgs_);
+        }
+        if (resultSet == nullptr) {
+            DEV_HILOGE(SERVICE, "query database failed");
+            return ERR_NG;
+        }
+        if (columnsStore_ != &store) {
+            if (ResolveColumns(*resultSet) != ERR_OK) {
+                resultSet->Close();
+                return ERR_NG;
+            }
+            columnsStore_ = &store;
+        }
+        int32_t ret = ReadBatch(*resultSet, timestamp, rows, count);
+        resultSet->Close();
+        if (ret != ERR_OK) {
+            return ret;
+        }
+        if (lastId == INVALID_ID) {
+            // An empty table has no history to skip, everything written from now on is new.
+            if (count == 0) {
+                lastId_.store(0);
+            }
+            break;
+        }
+    } while (count == BATCH_SIZE);
+    return ERR_OK;
+}
+
+int32_t DevicestatusRdbCursor::ResolveColumns(NativeRdb::ResultSet& resultSet)
+{
+    Columns columns;
+    if ((resultSet.GetColumnIndex("ID", columns.id) != ERR_OK) ||
+        (resultSet.GetColumnIndex("DEVICESTATUS_TYPE", columns.type) != ERR_OK) ||
+        (resultSet.GetColumnIndex("DEVICESTATUS_STATUS", columns.status) != ERR_OK)) {
+        DEV_HILOGE(SERVICE, "GetColumnIndex failed");
+        return ERR_NG;
+    }
+    columns_ = columns;
+    DEV_HILOGI(SERVICE, "columns: %{public}d %{public}d %{public}d", columns.id, columns.type, columns.status);
+    return ERR_OK;
+}
+
+int32_t DevicestatusRdbCursor::ReadBatch(NativeRdb::ResultSet& resultSet, int64_t timestamp,
+    std::vector<DevicestatusDataUtils::DevicestatusData>& rows, int32_t& count)
+{
+    count = 0;
+    DevicestatusDataUtils::DevicestatusData data;
+    data.timestamp = timestamp;
+    while (resultSet.GoToNextRow() == ERR_OK) {
+        int64_t id = 0;
+        if (resultSet.GetLong(columns_.id, id) != ERR_OK) {
+            DEV_HILOGE(SERVICE, "read ID failed after %{public}" PRId64, lastId_.load());
+            return ERR_NG;
+        }
+        lastId_.store(id);
+        ++count;
+        int32_t type = 0;
+        int32_t status = 0;
+        if ((resultSet.GetInt(columns_.type, type) != ERR_OK) ||
+            (resultSet.GetInt(columns_.status, status) != ERR_OK)) {
+            // Skip the row rather than stall the cursor on it.
+            DEV_HILOGE(SERVICE, "read row %{public}" PRId64 " failed", id);
+            continue;
+        }
+        data.type = static_cast<DevicestatusDataUtils::DevicestatusType>(type);
+        data.value = static_cast<DevicestatusDataUtils::DevicestatusValue>(status);
+        rows.push_back(data);
+    }
+    rowCount_.fetch_add(static_cast<uint64_t>(count), std::memory_order_relaxed);
+    DEV_HILOGD(SERVICE, "read %{public}d rows, last ID %{public}" PRId64, count, lastId_.load());
+    return ERR_OK;
+}
+} // namespace Msdp
+} // namespace OHOS
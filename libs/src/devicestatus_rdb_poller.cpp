@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "devicestatus_rdb_poller.h"
+
+#include <cinttypes>
+#include <cstdio>
+
+#include "rdb_helper.h"
+#include "rdb_open_callback.h"
+#include "rdb_store_config.h"
+#include "devicestatus_common.h"
+
+namespace OHOS {
+namespace Msdp {
+namespace {
+constexpr int32_t DATABASE_VERSION = 1;
+constexpr int64_t NS_PER_MS = 1000000;
+constexpr uint64_t NS_PER_US = 1000;
+constexpr size_t DUMP_BUFFER_SIZE = 256;
+constexpr int32_t ERR_NG = -1;
+
+// The writer creates and upgrades the store, a reader has nothing to do here.
+class ReaderOpenCallback : public NativeRdb::RdbOpenCallback {
+public:
+    int32_t OnCreate(NativeRdb::RdbStore &rdbStore) override
+    {
+        DEV_HILOGI(SERVICE, "Enter");
+        return ERR_OK;
+    }
+    int32_t OnUpgrade(NativeRdb::RdbStore &rdbStore, int32_t oldVersion, int32_t newVersion) override
+    {
+        DEV_HILOGI(SERVICE, "Enter");
+        return ERR_OK;
+    }
+};
+}
+
+DevicestatusRdbPoller::~DevicestatusRdbPoller()
+{
+    // The reactor outlives the plugin library, the timers may not fire after this.
+    DevicestatusReactor::GetInstance().Remove(timerId_);
+    DevicestatusReactor::GetInstance().Remove(retryId_);
+}
+
+bool DevicestatusRdbPoller::Init()
+{
+    DEV_HILOGI(SERVICE, "Enter, name: %{public}s", name_.c_str());
+    OpenStore();
+    timerId_ = DevicestatusReactor::GetInstance().AddTimer(name_ + ".poll", [this] { TimerCallback(); });
+    retryId_ = DevicestatusReactor::GetInstance().AddTimer(name_ + ".retry", [this] { RetryCallback(); });
+    if ((timerId_ == DevicestatusReactor::INVALID_ID) || (retryId_ == DevicestatusReactor::INVALID_ID)) {
+        DEV_HILOGE(SERVICE, "add timer failed");
+        return false;
+    }
+    return true;
+}
+
+void DevicestatusRdbPoller::OpenStore()
+{
+    // The writer owns the store; read-only WAL readers never block it and never take the write lock.
+    NativeRdb::RdbStoreConfig config(databaseName_, NativeRdb::StorageMode::MODE_DISK, true);
+    config.SetJournalMode(NativeRdb::JournalMode::MODE_WAL);
+    ReaderOpenCallback helper;
+    int32_t errCode = ERR_OK;
+    store_ = NativeRdb::RdbHelper::GetRdbStore(config, DATABASE_VERSION, helper, errCode);
+    storeOpen_.store(store_ != nullptr);
+    if (store_ == nullptr) {
+        DEV_HILOGE(SERVICE, "open %{public}s failed, errCode: %{public}d", databaseName_.c_str(), errCode);
+    }
+}
+
+void DevicestatusRdbPoller::Enable()
+{
+    enabled_.store(true);
+}
+
+void DevicestatusRdbPoller::Disable()
+{
+    enabled_.store(false);
+    StopPolling();
+}
+
+void DevicestatusRdbPoller::StartPolling()
+{
+    std::lock_guard lock(pollMutex_);
+    // Checked under the lock so that a poll started while the plugin is disabled cannot rearm the timer.
+    if (!enabled_.load()) {
+        return;
+    }
+    polling_ = true;
+    SetTimerInterval(pollInterval_.Reset());
+}
+
+void DevicestatusRdbPoller::StopPolling()
+{
+    // Disarm rather than remove, the same timer is armed again by the next StartPolling().
+    std::lock_guard lock(pollMutex_);
+    polling_ = false;
+    SetTimerInterval(0);
+}
+
+void DevicestatusRdbPoller::SetLowLatency(bool lowLatency)
+{
+    DEV_HILOGI(SERVICE, "%{public}s lowLatency: %{public}d", name_.c_str(), lowLatency);
+    std::lock_guard lock(pollMutex_);
+    // A subscriber that just arrived should not wait out an interval that backed off while it was away.
+    if (pollInterval_.SetLowLatency(lowLatency) && polling_) {
+        SetTimerInterval(pollInterval_.Get());
+    }
+}
+
+int32_t DevicestatusRdbPoller::Read()
+{
+    DEV_HILOGD(SERVICE, "Enter");
+    if (store_ == nullptr) {
+        // The writer may create the store after us; the reactor thread is shared, retry on a timer instead.
+        OpenStore();
+        if (store_ == nullptr) {
+            ScheduleRetry();
+            return ERR_NG;
+        }
+    }
+
+    // Both vectors keep their capacity between reads, a steady stream of rows does not allocate.
+    readRows_.clear();
+    changedRows_.clear();
+    int32_t ret = cursor_.Read(*store_, readRows_);
+    // Rows that repeat the current value of their type are writer noise, transitions go out in order.
+    for (const auto& row : readRows_) {
+        if (SaveRdbData(row)) {
+            changedRows_.push_back(row);
+        }
+    }
+    if (!changedRows_.empty()) {
+        notify_(changedRows_);
+    }
+    if (ret != ERR_OK) {
+        // Also the case of a store that exists before the writer created the table.
+        DEV_HILOGE(SERVICE, "read database failed");
+        ScheduleRetry();
+        return ERR_NG;
+    }
+    if (retryBackoff_.GetFailures() > 0) {
+        retryBackoff_.Reset();
+        if (retryPending_) {
+            DevicestatusReactor::GetInstance().DisarmTimer(retryId_);
+            retryPending_ = false;
+        }
+    }
+    return ERR_OK;
+}
+
+std::string DevicestatusRdbPoller::Dump() const
+{
+    int32_t timerInterval = 0;
+    bool lowLatency = false;
+    {
+        std::lock_guard lock(pollMutex_);
+        timerInterval = timerInterval_;
+        lowLatency = pollInterval_.IsLowLatency();
+    }
+    char buf[DUMP_BUFFER_SIZE];
+    int32_t len = snprintf(buf, sizeof(buf), "timerInterval=%dms lowLatency=%s wakeups=%" PRIu64
+        " store=%s retries=%" PRIu64 " lastId=%" PRId64 " rows=%" PRIu64 " reads=%" PRIu64 " readCpu=%" PRIu64 "us",
+        timerInterval, lowLatency ? "yes" : "no", wakeups_.load(std::memory_order_relaxed),
+        storeOpen_.load() ? "open" : "closed", retries_.load(std::memory_order_relaxed), cursor_.GetLastId(),
+        cursor_.GetRowCount(), cursor_.GetReadCount(), cursor_.GetReadCpuNs() / NS_PER_US);
+    return (len > 0) ? std::string(buf) : std::string();
+}
+
+void DevicestatusRdbPoller::SetTimerInterval(int32_t intervalMs)
+{
+    if (timerId_ == DevicestatusReactor::INVALID_ID) {
+        DEV_HILOGE(SERVICE, "timer is not created");
+        return;
+    }
+    timerInterval_ = intervalMs;
+    if (intervalMs <= 0) {
+        DevicestatusReactor::GetInstance().DisarmTimer(timerId_);
+        return;
+    }
+    // One shot, TimerCallback() picks the interval of the next poll from what this one found.
+    DevicestatusReactor::GetInstance().ArmTimer(timerId_, static_cast<int64_t>(intervalMs) * NS_PER_MS);
+}
+
+void DevicestatusRdbPoller::TimerCallback()
+{
+    wakeups_.fetch_add(1, std::memory_order_relaxed);
+    Read();
+    // changedRows_ still holds the transitions of the read above, only the reactor thread touches it.
+    std::lock_guard lock(pollMutex_);
+    if (polling_) {
+        SetTimerInterval(pollInterval_.Next(!changedRows_.empty()));
+    }
+}
+
+void DevicestatusRdbPoller::ScheduleRetry()
+{
+    // A read failing while a retry is pending does not push the retry further out.
+    if (retryPending_) {
+        return;
+    }
+    int64_t delayNs = retryBackoff_.Next();
+    retryPending_ = DevicestatusReactor::GetInstance().ArmTimer(retryId_, delayNs);
+    DEV_HILOGI(SERVICE, "%{public}s reads again in %{public}" PRId64 "ms, failures: %{public}u", name_.c_str(),
+        delayNs / NS_PER_MS, retryBackoff_.GetFailures());
+}
+
+void DevicestatusRdbPoller::RetryCallback()
+{
+    retryPending_ = false;
+    retries_.fetch_add(1, std::memory_order_relaxed);
+    if (!enabled_.load()) {
+        // Disabled meanwhile, the next Enable() reads again.
+        return;
+    }
+    Read();
+}
+
+bool DevicestatusRdbPoller::SaveRdbData(const DevicestatusDataUtils::DevicestatusData& data)
+{
+    DevicestatusDataUtils::DevicestatusValue* value = rdbDataMap_.Find(data.type);
+    if (value == nullptr) {
+        DEV_HILOGE(SERVICE, "invalid type: %{public}d", data.type);
+        return false;
+    }
+    if (*value == data.value) {
+        DEV_HILOGD(SERVICE, "data is not changed");
+        return false;
+    }
+    *value = data.value;
+    DEV_HILOGD(SERVICE, "type: %{public}d, value: %{public}d", data.type, data.value);
+    return true;
+}
+} // namespace Msdp
+} // namespace OHOS
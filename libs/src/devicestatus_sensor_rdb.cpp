@@ -17,22 +17,20 @@
 
 #include <string>
 #include <cerrno>
-#include <sys/epoll.h>
-#include <sys/timerfd.h>
+#include <cinttypes>
+#include <cstdio>
 #include <unistd.h>
 #include <linux/netlink.h>
 
 #include "dummy_values_bucket.h"
 #include "devicestatus_common.h"
+#include "devicestatus_reactor.h"
 
 using namespace OHOS::NativeRdb;
 namespace OHOS {
 namespace Msdp {
 namespace {
 const std::string DATABASE_NAME = "/data/MsdpStub.db";
-constexpr int32_t TIMER_INTERVAL = 3;
-constexpr int32_t ERR_INVALID_FD = -1;
-constexpr int32_t READ_RDB_WAIT_TIME = 30;
 constexpr int32_t SENSOR_SAMPLING_INTERVAL = 100000000;
 constexpr int32_t HALL_SENSOR_ID = 10;
 std::unique_ptr<DevicestatusSensorRdb> g_msdpRdb = std::make_unique<DevicestatusSensorRdb>();
@@ -52,19 +50,33 @@ static void OnReceivedSensorEvent(SensorEvent *event)
     g_rdb->HandleHallSensorEvent(event);
 }
 
+DevicestatusSensorRdb::DevicestatusSensorRdb()
+    : poller_("sensor_rdb", DATABASE_NAME,
+        [this](const std::vector<DevicestatusDataUtils::DevicestatusData>& batch) { NotifyMsdpImpl(batch); })
+{
+}
+
 bool DevicestatusSensorRdb::Init()
 {
     DEV_HILOGI(SERVICE, "Enter");
-    InitRdbStore();
-    InitTimer();
-    StartThread();
+    if (initialized_) {
+        // The timers outlive Disable(), polling only needs to start over.
+        poller_.Enable();
+        poller_.StartPolling();
+        return true;
+    }
+    if (!poller_.Init()) {
+        DEV_HILOGE(SERVICE, "init poller failed");
+        return false;
+    }
+    poller_.Enable();
+    poller_.StartPolling();
+    DevicestatusReactor::GetInstance().Start();
+    initialized_ = true;
     DEV_HILOGI(SERVICE, "Exit");
     return true;
 }
 
-void DevicestatusSensorRdb::InitRdbStore()
-{}
-
 void DevicestatusSensorRdb::RegisterCallback(const std::shared_ptr<DevicestatusSensorHdiCallback>& callback)
 {
     callbacksImpl_ = callback;
@@ -86,11 +98,15 @@ void DevicestatusSensorRdb::Enable()
 void DevicestatusSensorRdb::Disable()
 {
     DEV_HILOGI(SERVICE, "Enter");
-    CloseTimer();
+    poller_.Disable();
     UnSubscribeHallSensor();
     DEV_HILOGI(SERVICE, "Exit");
 }
 
+std::string DevicestatusSensorRdb::Dump()
+{
+    return "notified=" + std::to_string(notified_.load(std::memory_order_relaxed)) + " " + poller_.Dump();
+}
 
 ErrCode DevicestatusSensorRdb::NotifyMsdpImpl(const DevicestatusDataUtils::DevicestatusData& data)
 {
@@ -104,134 +120,23 @@ ErrCode DevicestatusSensorRdb::NotifyMsdpImpl(const DevicestatusDataUtils::Devic
         return ERR_NG;
     }
     g_rdb->GetCallbacksImpl()->OnSensorHdiResult(data);
+    notified_.fetch_add(1, std::memory_order_relaxed);
 
     return ERR_OK;
 }
-
-DevicestatusDataUtils::DevicestatusData DevicestatusSensorRdb::SaveRdbData(
-    const DevicestatusDataUtils::DevicestatusData& data)
-{
-    for (auto iter = rdbDataMap_.begin(); iter != rdbDataMap_.end(); ++iter) {
-        if (iter->first == data.type) {
-            if (iter->second != data.value) {
-                notifyFlag_ = true;
-                iter->second = data.value;
-            }
-            DEV_HILOGI(SERVICE, "data is not changed");
-            return data;
-        }
-    }
-
-    rdbDataMap_.insert(std::make_pair(data.type, data.value));
-    notifyFlag_ = true;
-
-    DEV_HILOGI(SERVICE, "devicestatusType_ = %{public}d, devicestatusStatus_ = %{public}d",
-        devicestatusType_, devicestatusStatus_);
-
-    return data;
-}
-
-int32_t DevicestatusSensorRdb::TrigerData(const std::unique_ptr<NativeRdb::ResultSet> &resultSet)
-{
-    int32_t columnIndex;
-    int32_t intVal;
-
-    if (resultSet == nullptr) {
-        DEV_HILOGE(SERVICE, "resultSet is nullprt");
-        return -1;
-    }
-    int32_t ret = resultSet->GetColumnIndex("ID", columnIndex);
-    DEV_HILOGI(SERVICE, "TrigerDatabaseObserver GetColumnIndex = %{public}d", columnIndex);
-    if (ret != ERR_OK) {
-        DEV_HILOGE(SERVICE, "CheckID: GetColumnIndex failed");
-        return -1;
-    }
-    ret = resultSet->GetInt(columnIndex, intVal);
-    DEV_HILOGI(SERVICE, "ret = %{public}d, id = %{public}d", ret, intVal);
-    if (ret != ERR_OK) {
-        DEV_HILOGE(SERVICE, "CheckID: GetValue failed");
-        return -1;
-    }
-
-    ret = resultSet->GetColumnIndex("DEVICESTATUS_TYPE", columnIndex);
-    DEV_HILOGI(SERVICE, "DEVICESTATUS_TYPE GetColumnIndex = %{public}d", columnIndex);
-    if (ret != ERR_OK) {
-        DEV_HILOGE(SERVICE, "CheckDevicestatusType: GetColumnIndex failed");
-        return -1;
-    }
-    ret = resultSet->GetInt(columnIndex, intVal);
-    DEV_HILOGI(SERVICE, "ret = %{public}d, DevicestatusType = %{public}d", ret, intVal);
-    devicestatusType_ = intVal;
-    if (ret != ERR_OK) {
-        DEV_HILOGE(SERVICE, "CheckDevicestatusType: GetValue failed");
-        return -1;
-    }
-
-    ret = resultSet->GetColumnIndex("DEVICESTATUS_STATUS", columnIndex);
-    DEV_HILOGI(SERVICE, "DEVICESTATUS_STATUS GetColumnIndex = %{public}d", columnIndex);
-    if (ret != ERR_OK) {
-        DEV_HILOGE(SERVICE, "CheckDevicestatusStatus: GetColumnIndex failed");
-        return -1;
-    }
-    ret = resultSet->GetInt(columnIndex, intVal);
-    DEV_HILOGI(SERVICE, "ret = %{public}d, DevicestatusStatus = %{public}d", ret, intVal);
-    devicestatusStatus_ = intVal;
-    if (ret != ERR_OK) {
-        DEV_HILOGE(SERVICE, "CheckDevicestatusStatus: GetValue failed");
-        return -1;
-    }
-
-    return ERR_OK;
-}
-
-int32_t DevicestatusSensorRdb::TrigerDatabaseObserver()
+ErrCode DevicestatusSensorRdb::NotifyMsdpImpl(const std::vector<DevicestatusDataUtils::DevicestatusData>& batch)
 {
-    DEV_HILOGI(SERVICE, "Enter");
-
-    if (store_ == nullptr) {
-        sleep(READ_RDB_WAIT_TIME);
-        InitRdbStore();
-        return -1;
-    }
-
-    std::unique_ptr<ResultSet> resultSet =
-        store_->QuerySql("SELECT * FROM DEVICESTATUSSENSOR WHERE ID = (SELECT max(ID) from DEVICESTATUSSENSOR)");
-
-    if (resultSet == nullptr) {
-        DEV_HILOGE(SERVICE, "database is not exist");
-        return -1;
-    }
-
-    int32_t ret = resultSet->GoToFirstRow();
-    DEV_HILOGI(SERVICE, "GoToFirstRow = %{public}d", ret);
-    if (ret != ERR_OK) {
-        sleep(READ_RDB_WAIT_TIME);
-        DEV_HILOGE(SERVICE, "database observer is null");
-        return -1;
-    }
-
-    if (TrigerData(resultSet) != ERR_OK) {
-        DEV_HILOGE(SERVICE, "triger data failed");
-        return -1;
-    }
-
-    ret = resultSet->Close();
-    if (ret != ERR_OK) {
-        DEV_HILOGE(SERVICE, "close database observer failed");
-        return -1;
+    if (g_rdb == nullptr) {
+        DEV_HILOGE(SERVICE, "g_rdb is nullptr");
+        return ERR_NG;
     }
-
-    DevicestatusDataUtils::DevicestatusData data;
-    data.type = (DevicestatusDataUtils::DevicestatusType)devicestatusType_;
-    data.value = (DevicestatusDataUtils::DevicestatusValue)devicestatusStatus_;
-
-    SaveRdbData(data);
-    DEV_HILOGI(SERVICE, "notifyFlag_ is %{public}d", notifyFlag_);
-    if (notifyFlag_) {
-        NotifyMsdpImpl(data);
-        notifyFlag_ = false;
+    std::shared_ptr<DevicestatusSensorHdiCallback> callback = g_rdb->GetCallbacksImpl();
+    if (callback == nullptr) {
+        DEV_HILOGI(SERVICE, "callbacksImpl is nullptr");
+        return ERR_NG;
     }
-
+    callback->OnSensorHdiResultBatch(batch);
+    notified_.fetch_add(batch.size(), std::memory_order_relaxed);
     return ERR_OK;
 }
 
@@ -254,6 +159,7 @@ void DevicestatusSensorRdb::HandleHallSensorEvent(SensorEvent *event)
             curLidStatus = eventFilter;
             data.type = DevicestatusDataUtils::DevicestatusType::TYPE_LID_OPEN;
             data.value = DevicestatusDataUtils::DevicestatusValue(curLidStatus);
+            data.timestamp = DevicestatusGetBootTime();
             NotifyMsdpImpl(data);
         }
     }
@@ -284,130 +190,9 @@ void DevicestatusSensorRdb::UnSubscribeHallSensor()
     DEV_HILOGI(SERVICE, "Exit");
 }
 
-void DevicestatusSensorRdb::InitTimer()
-{
-    DEV_HILOGI(SERVICE, "Enter");
-    epFd_ = epoll_create1(EPOLL_CLOEXEC);
-    if (epFd_ == -1) {
-        DEV_HILOGI(SERVICE, "create epoll fd failed");
-        return;
-    }
-    timerFd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
-    if (timerFd_ == ERR_INVALID_FD) {
-        DEV_HILOGI(SERVICE, "create timer fd failed");
-        return;
-    }
-    SetTimerInterval(TIMER_INTERVAL);
-    fcntl(timerFd_, F_SETFL, O_NONBLOCK);
-    callbacks_.insert(std::make_pair(timerFd_, &DevicestatusSensorRdb::TimerCallback));
-    if (RegisterTimerCallback(timerFd_, EVENT_TIMER_FD)) {
-        DEV_HILOGI(SERVICE, "register timer fd failed");
-        return;
-    }
-}
-
-void DevicestatusSensorRdb::SetTimerInterval(int32_t interval)
-{
-    struct itimerspec itval;
-
-    if (timerFd_ == ERR_INVALID_FD) {
-        DEV_HILOGE(SERVICE, "create timer fd failed");
-        return;
-    }
-
-    timerInterval_ = interval;
-
-    if (interval < 0) {
-        interval = 0;
-    }
-
-    itval.it_interval.tv_sec = interval;
-    itval.it_interval.tv_nsec = 0;
-    itval.it_value.tv_sec = interval;
-    itval.it_value.tv_nsec = 0;
-
-    if (timerfd_settime(timerFd_, 0, &itval, nullptr) == -1) {
-        DEV_HILOGI(SERVICE, "set timer failed");
-        return;
-    }
-
-    return;
-}
-
-void DevicestatusSensorRdb::CloseTimer()
-{
-    DEV_HILOGI(SERVICE, "Enter");
-    close(timerFd_);
-    DEV_HILOGI(SERVICE, "Exit");
-}
-
-void DevicestatusSensorRdb::TimerCallback()
-{
-    unsigned long long timers;
-    if (read(timerFd_, &timers, sizeof(timers)) == -1) {
-        DEV_HILOGI(SERVICE, "read timer fd failed");
-        return;
-    }
-    TrigerDatabaseObserver();
-}
-
-int32_t DevicestatusSensorRdb::RegisterTimerCallback(const int32_t fd, const EventType et)
+void DevicestatusSensorRdb::SetLowLatency(bool lowLatency)
 {
-    DEV_HILOGI(SERVICE, "Enter");
-    struct epoll_event ev;
-
-    ev.events = EPOLLIN;
-    if (et == EVENT_TIMER_FD) {
-        ev.events |= EPOLLWAKEUP;
-    }
-
-    ev.data.ptr = reinterpret_cast<void*>(this);
-    ev.data.fd = fd;
-    if (epoll_ctl(epFd_, EPOLL_CTL_ADD, fd, &ev) == -1) {
-        DEV_HILOGI(SERVICE, "epoll_ctl failed, error num =%{public}d", errno);
-        return -1;
-    }
-
-    return 0;
-}
-
-void DevicestatusSensorRdb::StartThread()
-{
-    DEV_HILOGI(SERVICE, "Enter");
-    std::make_unique<std::thread>(&DevicestatusSensorRdb::LoopingThreadEntry, this)->detach();
-}
-
-void DevicestatusSensorRdb::LoopingThreadEntry()
-{
-    size_t cbct = callbacks_.size();
-    struct epoll_event events[cbct];
-
-    while (true) {
-        int32_t timeout = -1;
-
-        int32_t nevents = epoll_wait(epFd_, events, cbct, timeout);
-        if (nevents == -1) {
-            continue;
-        }
-        for (int32_t n = 0; n < nevents; ++n) {
-            if (events[n].data.ptr) {
-                DevicestatusSensorRdb *func = const_cast<DevicestatusSensorRdb *>(this);
-                (callbacks_.find(events[n].data.fd)->second)(func);
-            }
-        }
-    }
-}
-
-int32_t HelperCallback::OnCreate(RdbStore &store)
-{
-    DEV_HILOGI(SERVICE, "Enter");
-    return ERR_OK;
-}
-
-int32_t HelperCallback::OnUpgrade(RdbStore &store, int32_t oldVersion, int32_t newVersion)
-{
-    DEV_HILOGI(SERVICE, "Enter");
-    return ERR_OK;
+    poller_.SetLowLatency(lowLatency);
 }
 
 extern "C" DevicestatusSensorInterface *Create(void)
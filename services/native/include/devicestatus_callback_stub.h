@@ -34,6 +34,7 @@ public:
 
 private:
     int32_t OnDevicestatusChangedStub(MessageParcel& data);
+    void ReadDataExtension(MessageParcel& data, DevicestatusDataUtils::DevicestatusData& devicestatusData);
 };
 } // namespace Msdp
 } // namespace OHOS
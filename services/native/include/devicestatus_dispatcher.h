@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DEVICESTATUS_DISPATCHER_H
+#define DEVICESTATUS_DISPATCHER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <nocopyable.h>
+
+#include "devicestatus_data_utils.h"
+#include "devicestatus_subscriber.h"
+#include "devicestatus_type_table.h"
+
+namespace OHOS {
+namespace Msdp {
+/*
+ * Moves event delivery off the producer thread. Producers only copy the event into a bounded ring; a single
+ * fan-out thread moves the events, in the order they were dispatched, into the per-subscriber mailboxes, and
+ * a small worker pool drains subscribers that have pending events, one worker per subscriber at a time. A
+ * client blocked in a binder call therefore holds one worker and never delays delivery to other subscribers
+ * while a worker is free, and the mailboxes never see two values of a type out of order. When the ring is full
+ * the oldest event of a type that has a newer one queued is dropped, so the last value of every type is
+ * always delivered; the capacity must therefore exceed the number of types.
+ */
+class DevicestatusDispatcher {
+public:
+    using FanoutHandler = std::function<void(const DevicestatusDataUtils::DevicestatusData& data)>;
+    static constexpr size_t DEFAULT_WORKER_COUNT = 4;
+    static constexpr size_t DEFAULT_QUEUE_CAPACITY = 64;
+
+    DevicestatusDispatcher() = default;
+    ~DevicestatusDispatcher();
+    DISALLOW_COPY_AND_MOVE(DevicestatusDispatcher);
+
+    bool Start(const FanoutHandler& handler, size_t workerCount = DEFAULT_WORKER_COUNT,
+        size_t capacity = DEFAULT_QUEUE_CAPACITY);
+    void Stop();
+    bool IsRunning() const;
+    bool Dispatch(const DevicestatusDataUtils::DevicestatusData& data);
+    void Schedule(const std::shared_ptr<DevicestatusSubscriber>& subscriber);
+    size_t GetQueueDepth() const;
+    size_t GetReadyCount() const;
+    uint64_t GetDroppedCount() const;
+
+private:
+    size_t FindEvictableLocked(const DevicestatusDataUtils::DevicestatusData& data) const;
+    void EvictLocked(size_t offset);
+    void FanoutEntry();
+    void WorkerEntry(size_t index);
+
+    FanoutHandler handler_;
+    mutable std::mutex mutex_;
+    // Signals the fan-out thread about ring_ and the workers about ready_.
+    std::condition_variable eventCond_;
+    std::condition_variable cond_;
+    std::vector<DevicestatusDataUtils::DevicestatusData> ring_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+    // Number of events of each type in ring_.
+    DevicestatusTypeTable<size_t> queued_;
+    std::deque<std::shared_ptr<DevicestatusSubscriber>> ready_;
+    std::thread fanout_;
+    std::vector<std::thread> workers_;
+    std::atomic<bool> running_ {false};
+    std::atomic<uint64_t> dropped_ {0};
+};
+} // namespace Msdp
+} // namespace OHOS
+#endif // DEVICESTATUS_DISPATCHER_H
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DEVICESTATUS_FILTER_H
+#define DEVICESTATUS_FILTER_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <nocopyable.h>
+
+#include "devicestatus_data_utils.h"
+#include "devicestatus_reactor.h"
+#include "devicestatus_type_table.h"
+
+namespace OHOS {
+namespace Msdp {
+/*
+ * Per-type filter between the sources and the service state. A transition is committed only after the new
+ * value has been reported for the dwell time of its direction, so a flap that returns within the dwell is
+ * suppressed; entering and exiting may use different dwell times to get hysteresis. Committed transitions
+ * of a type are also capped to maxPerSecond with a token bucket, and a transition over the cap waits for a
+ * token instead of being lost. A type with the default config passes straight through on the producer
+ * thread without taking the filter lock; every other type is committed in order from a reactor timer
+ * through the commit handler.
+ */
+class DevicestatusFilter {
+public:
+    using CommitHandler = std::function<void(const DevicestatusDataUtils::DevicestatusData& data)>;
+    struct Config {
+        uint32_t enterDwellMs = 0;
+        uint32_t exitDwellMs = 0;
+        // 0 means no cap.
+        uint32_t maxPerSecond = 0;
+
+        bool IsPassThrough() const
+        {
+            return (enterDwellMs == 0) && (exitDwellMs == 0) && (maxPerSecond == 0);
+        }
+    };
+    struct Stats {
+        uint64_t passed = 0;
+        // Transitions that were reverted or replaced before they were committed.
+        uint64_t suppressed = 0;
+        // Transitions that waited for their dwell time or for a token before they were committed.
+        uint64_t delayed = 0;
+    };
+
+    static constexpr uint32_t MAX_DWELL_MS = 60000;
+    static constexpr uint32_t MAX_PER_SECOND = 1000;
+
+    DevicestatusFilter() = default;
+    ~DevicestatusFilter();
+    DISALLOW_COPY_AND_MOVE(DevicestatusFilter);
+
+    bool Start(const CommitHandler& handler);
+    // Must be called before the filter is destroyed and before the reactor is stopped.
+    void Stop();
+    int32_t SetConfig(DevicestatusDataUtils::DevicestatusType type, const Config& config);
+    /*
+     * Applies the per-type configs of a JSON file shaped like
+     *     { "filters": [ { "type": "LID_OPEN", "enterDwellMs": 0, "exitDwellMs": 0, "maxPerSecond": 0 } ] }
+     * where type is a type name or its number. A missing file leaves every type pass-through; an invalid entry
+     * is skipped and reported, the valid ones are still applied.
+     */
+    int32_t LoadConfig(const std::string& path);
+    Config GetConfig(DevicestatusDataUtils::DevicestatusType type);
+    Stats GetStats(DevicestatusDataUtils::DevicestatusType type);
+    // Returns true when the caller should commit the event itself, right now.
+    bool Filter(const DevicestatusDataUtils::DevicestatusData& data);
+    void Dump(std::string& out);
+
+private:
+    struct State {
+        Config config;
+        // passed is counted in the atomic below, the other fields are guarded by mutex_.
+        Stats stats;
+        // Set while the type is pass-through with nothing pending or in flight: Filter() then commits without
+        // taking mutex_. Only cleared or set under mutex_.
+        std::atomic<bool> unfiltered {true};
+        // Also written on the lock-free path, hence atomic.
+        std::atomic<bool> committed {false};
+        std::atomic<DevicestatusDataUtils::DevicestatusValue> value {
+            DevicestatusDataUtils::DevicestatusValue::VALUE_INVALID};
+        std::atomic<uint64_t> passed {0};
+        bool pending = false;
+        DevicestatusDataUtils::DevicestatusData pendingData {};
+        int64_t pendingTime = 0;
+        int64_t deadline = 0;
+        // Commits handed to the handler and not yet returned; the producer must not overtake them.
+        uint32_t inflight = 0;
+        double tokens = 0.0;
+        int64_t refillTime = 0;
+    };
+
+    static int64_t GetDwell(const State& state, DevicestatusDataUtils::DevicestatusValue value);
+    static void Refill(State& state, int64_t now);
+    static int64_t GetTokenTime(State& state, int64_t now);
+    void ScheduleLocked(int64_t deadline, int64_t now);
+    void OnTimer();
+
+    CommitHandler handler_;
+    std::mutex mutex_;
+    DevicestatusTypeTable<State> states_;
+    DevicestatusReactor::Id timerId_ = DevicestatusReactor::INVALID_ID;
+    // Deadline the reactor timer is armed for, 0 when it is not armed.
+    int64_t armedDeadline_ = 0;
+    std::atomic<bool> running_ {false};
+};
+} // namespace Msdp
+} // namespace OHOS
+#endif // DEVICESTATUS_FILTER_H
@@ -16,20 +16,28 @@
 #ifndef DEVICESTATUS_MANAGER_H
 #define DEVICESTATUS_MANAGER_H
 
+#include <array>
+#include <atomic>
 #include <set>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 #include "sensor_if.h"
 #include "devicestatus_data_utils.h"
 #include "idevicestatus_algorithm.h"
 #include "idevicestatus_callback.h"
 #include "devicestatus_common.h"
+#include "devicestatus_dispatcher.h"
 #include "devicestatus_msdp_client_impl.h"
+#include "devicestatus_type_table.h"
 
 namespace OHOS {
 namespace Msdp {
 class DevicestatusService;
-class DevicestatusManager {
+class DevicestatusManager : public std::enable_shared_from_this<DevicestatusManager> {
 public:
     explicit DevicestatusManager(const wptr<DevicestatusService>& ms) : ms_(ms)
     {
@@ -39,40 +47,94 @@ public:
 
     class DevicestatusCallbackDeathRecipient : public IRemoteObject::DeathRecipient {
     public:
-        DevicestatusCallbackDeathRecipient() = default;
+        explicit DevicestatusCallbackDeathRecipient(const std::weak_ptr<DevicestatusManager>& manager)
+            : manager_(manager) {}
         virtual void OnRemoteDied(const wptr<IRemoteObject> &remote);
         virtual ~DevicestatusCallbackDeathRecipient() = default;
+    private:
+        std::weak_ptr<DevicestatusManager> manager_;
     };
 
     bool Init();
-    bool EnableRdb();
-    bool InitInterface();
-    bool DisableRdb();
+    bool EnableRdb(const DevicestatusDataUtils::DevicestatusType& type);
+    bool DisableRdb(const DevicestatusDataUtils::DevicestatusType& type);
     bool InitDataCallback();
     void NotifyDevicestatusChange(const DevicestatusDataUtils::DevicestatusData& devicestatusData);
+    void FanoutDevicestatusChange(const DevicestatusDataUtils::DevicestatusData& devicestatusData);
     void Subscribe(const DevicestatusDataUtils::DevicestatusType& type, const sptr<IdevicestatusCallback>& callback);
     void UnSubscribe(const DevicestatusDataUtils::DevicestatusType& type, const sptr<IdevicestatusCallback>& callback);
+    int32_t SubscribeTypes(uint32_t typeMask, const sptr<IdevicestatusCallback>& callback,
+        DevicestatusTypeTable<int32_t>& results);
+    int32_t UnSubscribeTypes(uint32_t typeMask, const sptr<IdevicestatusCallback>& callback,
+        DevicestatusTypeTable<int32_t>& results);
+    // Switches a subscribed callback to event ring delivery; takes ownership of doorbellFd.
+    int32_t AttachEventRing(const sptr<IdevicestatusCallback>& callback, const sptr<Ashmem>& memory,
+        int32_t doorbellFd);
+    int32_t DetachEventRing(const sptr<IdevicestatusCallback>& callback);
+    size_t ReapDeadSubscriber(const sptr<IRemoteObject>& object);
     DevicestatusDataUtils::DevicestatusData GetLatestDevicestatusData(const \
         DevicestatusDataUtils::DevicestatusType& type);
+    int32_t GetLatestDevicestatusSnapshot(uint32_t typeMask,
+        DevicestatusTypeTable<DevicestatusLatestState::Entry>& entries);
     int32_t SensorDataCallback(const struct SensorEvents *event);
     int32_t MsdpDataCallback(const DevicestatusDataUtils::DevicestatusData& data);
     int32_t LoadAlgorithm(bool bCreate);
     int32_t UnloadAlgorithm(bool bCreate);
+    DevicestatusSubscriber::Stats GetDeliveryStats();
+    uint64_t GetReapedCount();
+    // Stops the event filter; the service calls it before it stops the reactor the filter's timer is on.
+    void StopFilter();
+    void Dump(std::string& out);
 
 private:
+    using ListenerSnapshot = std::vector<std::shared_ptr<DevicestatusSubscriber>>;
+
     struct classcomp {
         bool operator()(const sptr<IdevicestatusCallback> &l, const sptr<IdevicestatusCallback> &r) const
         {
             return l->AsObject() < r->AsObject();
         }
     };
+    // Reverse index entry: everything one remote callback is subscribed to.
+    struct SubscriptionRecord {
+        std::shared_ptr<DevicestatusSubscriber> subscriber;
+        std::set<DevicestatusDataUtils::DevicestatusType> types;
+    };
+    std::shared_ptr<const ListenerSnapshot> GetListenerSnapshot(
+        const DevicestatusDataUtils::DevicestatusType& type) const;
+    void PublishListenerSnapshot(const DevicestatusDataUtils::DevicestatusType& type);
+    int32_t SubscribeLocked(const DevicestatusDataUtils::DevicestatusType& type,
+        const sptr<IdevicestatusCallback>& callback);
+    int32_t UnSubscribeLocked(const DevicestatusDataUtils::DevicestatusType& type,
+        const sptr<IdevicestatusCallback>& callback);
+    void RemoveSubscription(const DevicestatusDataUtils::DevicestatusType& type,
+        const sptr<IdevicestatusCallback>& callback);
+    void RemoveSubscriber(std::map<sptr<IRemoteObject>, SubscriptionRecord>::iterator recordIter);
+    // Tells every source whether a subscriber with an event ring needs it; called with mutex_ held.
+    void UpdateSourceLatency();
     const wptr<DevicestatusService> ms_;
     std::mutex mutex_;
     sptr<IRemoteObject::DeathRecipient> devicestatusCBDeathRecipient_;
     std::unique_ptr<DevicestatusMsdpClientImpl> msdpImpl_;
-    std::map<DevicestatusDataUtils::DevicestatusType, DevicestatusDataUtils::DevicestatusValue> msdpData_;
-    std::map<DevicestatusDataUtils::DevicestatusType, std::set<const sptr<IdevicestatusCallback>, classcomp>> \
-        listenerMap_;
+    DevicestatusTypeTable<std::set<const sptr<IdevicestatusCallback>, classcomp>> listenerMap_;
+    std::map<sptr<IRemoteObject>, SubscriptionRecord> subscribers_;
+    DevicestatusSubscriber::Stats retiredStats_;
+    uint64_t reapedCount_ = 0;
+    // Number of subscribed types backed by each source; a source runs only while its count is non-zero.
+    std::array<uint32_t, DevicestatusMsdpClientImpl::SOURCE_MAX> sourceRefs_ {};
+    // Sources last told that a latency sensitive subscriber needs them.
+    std::array<bool, DevicestatusMsdpClientImpl::SOURCE_MAX> lowLatencySources_ {};
+    bool dataCallbackRegistered_ = false;
+    // Events seen per type, and the counts and time of the previous Dump() to report rates between dumps.
+    DevicestatusTypeTable<std::atomic<uint64_t>> eventCounts_;
+    DevicestatusTypeTable<uint64_t> dumpedEventCounts_;
+    int64_t dumpedTime_ = 0;
+    // Immutable per-type copies of listenerMap_, rebuilt under mutex_. The notify path reads them with
+    // std::atomic_load, which is not lock-free: the standard library guards it with a short lock from a
+    // global pool, held only to copy the pointer. What it buys is that notify never waits on mutex_.
+    DevicestatusTypeTable<std::shared_ptr<const ListenerSnapshot>> listenerSnapshots_;
+    // Declared last so the dispatcher workers are joined before the state they read is destroyed.
+    DevicestatusDispatcher dispatcher_;
 };
 } // namespace Msdp
 } // namespace OHOS
@@ -34,6 +34,7 @@
 #include "devicestatus_delayed_sp_singleton.h"
 #include "devicestatus_msdp_interface.h"
 #include "devicestatus_sensor_interface.h"
+#include "devicestatus_latest_state.h"
 
 namespace OHOS {
 namespace Msdp {
@@ -42,18 +43,28 @@ class DevicestatusMsdpClientImpl :
     public DevicestatusSensorInterface::DevicestatusSensorHdiCallback {
 public:
     using CallbackManager = std::function<int32_t(const DevicestatusDataUtils::DevicestatusData&)>;
+    // Backend plugin that produces the events of a DevicestatusType.
+    enum SourceType {
+        SOURCE_MSDP_ALGORITHM = 0,
+        SOURCE_SENSOR_HDI,
+        SOURCE_MAX,
+    };
 
-    ErrCode InitMsdpImpl();
-    ErrCode DisableMsdpImpl();
+    static SourceType GetSourceType(const DevicestatusDataUtils::DevicestatusType& type);
+    ErrCode EnableSource(SourceType source);
+    ErrCode DisableSource(SourceType source);
+    ErrCode SetSourceLowLatency(SourceType source, bool lowLatency);
     ErrCode RegisterImpl(const CallbackManager& callback);
-    ErrCode UnregisterImpl();
+    void StopFilter();
     int32_t MsdpCallback(const DevicestatusDataUtils::DevicestatusData& data);
     ErrCode RegisterMsdp();
     ErrCode UnregisterMsdp(void);
     ErrCode RegisterSensor();
     ErrCode UnregisterSensor(void);
-    DevicestatusDataUtils::DevicestatusData SaveObserverData(const DevicestatusDataUtils::DevicestatusData& data);
-    std::map<DevicestatusDataUtils::DevicestatusType, DevicestatusDataUtils::DevicestatusValue> GetObserverData() const;
+    static DevicestatusDataUtils::DevicestatusData SaveObserverData(
+        const DevicestatusDataUtils::DevicestatusData& data);
+    bool GetObserverData(const DevicestatusDataUtils::DevicestatusType& type,
+        DevicestatusLatestState::Entry& entry) const;
     void GetDevicestatusTimestamp();
     void GetLongtitude();
     void GetLatitude();
@@ -61,14 +72,17 @@ public:
     int32_t UnloadAlgorithmLibrary(bool bCreate);
     int32_t LoadSensorHdiLibrary(bool bCreate);
     int32_t UnloadSensorHdiLibrary(bool bCreate);
+    void Dump(std::string& out);
 private:
-    ErrCode ImplCallback(const DevicestatusDataUtils::DevicestatusData& data);
+    // Runs an event the filter held back through the rest of the pipeline.
+    static void CommitData(const DevicestatusDataUtils::DevicestatusData& data);
     DevicestatusSensorInterface* GetSensorHdiInst();
     DevicestatusMsdpInterface* GetAlgorithmInst();
     MsdpAlgorithmHandle mAlgorithm_;
     SensorHdiHandle sensorHdi_;
     std::mutex mMutex_;
-    bool notifyManagerFlag_ = false;
+    bool msdpRegistered_ = false;
+    bool sensorRegistered_ = false;
     void OnResult(const DevicestatusDataUtils::DevicestatusData& data) override;
     void OnSensorHdiResult(const DevicestatusDataUtils::DevicestatusData& data) override;
 };
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DEVICESTATUS_PIPELINE_H
+#define DEVICESTATUS_PIPELINE_H
+
+#include <cstddef>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "devicestatus_common.h"
+#include "devicestatus_data_utils.h"
+#include "devicestatus_latency_stats.h"
+
+namespace OHOS {
+namespace Msdp {
+/*
+ * Event processing chain fixed at compile time. Each stage is a plain class with
+ *     bool Process(DevicestatusDataUtils::DevicestatusData& data);
+ *     void Dump(std::string& out) const;
+ * and the stages run in order on the calling thread until one returns false, which means the stage consumed,
+ * dropped or deferred the event. The chain is a fold over a tuple, so stages are inlined into one function:
+ * adding a stage adds no hop, lock or virtual call. A stage that defers an event resumes it later with
+ * Process<IndexOf<Stage>() + 1>().
+ */
+template<typename... Stages>
+class DevicestatusPipeline {
+public:
+    static_assert(sizeof...(Stages) > 0, "a pipeline needs at least one stage");
+    static_assert((std::is_same_v<bool,
+        decltype(std::declval<Stages&>().Process(std::declval<DevicestatusDataUtils::DevicestatusData&>()))> && ...),
+        "stage Process must take DevicestatusData& and return bool");
+
+    template<typename Stage>
+    static constexpr size_t IndexOf()
+    {
+        constexpr bool matches[] = { std::is_same_v<Stage, Stages>... };
+        for (size_t i = 0; i < sizeof...(Stages); ++i) {
+            if (matches[i]) {
+                return i;
+            }
+        }
+        return sizeof...(Stages);
+    }
+
+    // Runs the stages from First on; returns true when the event went through all of them.
+    template<size_t First = 0>
+    bool Process(DevicestatusDataUtils::DevicestatusData& data)
+    {
+        static_assert(First <= sizeof...(Stages), "no such stage");
+        return ProcessFrom<First>(data, std::make_index_sequence<sizeof...(Stages) - First>());
+    }
+
+    template<typename Stage>
+    Stage& Get()
+    {
+        return std::get<IndexOf<Stage>()>(stages_);
+    }
+
+    void Dump(std::string& out) const
+    {
+        std::apply([&out](const auto&... stage) { (stage.Dump(out), ...); }, stages_);
+    }
+
+private:
+    template<size_t First, size_t... I>
+    bool ProcessFrom(DevicestatusDataUtils::DevicestatusData& data, std::index_sequence<I...>)
+    {
+        return (std::get<First + I>(stages_).Process(data) && ...);
+    }
+
+    std::tuple<Stages...> stages_;
+};
+
+// Gives events from sources that do not time their observations the time they entered the service.
+class DevicestatusStampStage {
+public:
+    bool Process(DevicestatusDataUtils::DevicestatusData& data)
+    {
+        if (data.timestamp == 0) {
+            data.timestamp = DevicestatusGetBootTime();
+        }
+        return true;
+    }
+    void Dump(std::string& out) const {}
+};
+
+// Records the latency from the source to this point of the pipeline.
+template<DevicestatusLatencyStats::Hop HOP>
+class DevicestatusLatencyStage {
+public:
+    bool Process(DevicestatusDataUtils::DevicestatusData& data)
+    {
+        DevicestatusLatencyStats::GetInstance().RecordSince(HOP, data);
+        return true;
+    }
+    void Dump(std::string& out) const {}
+};
+} // namespace Msdp
+} // namespace OHOS
+#endif // DEVICESTATUS_PIPELINE_H
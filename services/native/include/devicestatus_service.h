@@ -17,6 +17,8 @@
 #define DEVICESTATUS_SERVICE_H
 
 #include <memory>
+#include <string>
+#include <vector>
 #include <iremote_object.h>
 #include <system_ability.h>
 
@@ -34,12 +36,21 @@ class DevicestatusService final : public SystemAbility, public DevicestatusSrvSt
 public:
     virtual void OnStart() override;
     virtual void OnStop() override;
+    int32_t Dump(int32_t fd, const std::vector<std::u16string>& args) override;
 
     void Subscribe(const DevicestatusDataUtils::DevicestatusType& type, \
         const sptr<IdevicestatusCallback>& callback) override;
     void UnSubscribe(const DevicestatusDataUtils::DevicestatusType& type, \
         const sptr<IdevicestatusCallback>& callback) override;
     DevicestatusDataUtils::DevicestatusData GetCache(const DevicestatusDataUtils::DevicestatusType& type) override;
+    int32_t SubscribeTypes(uint32_t typeMask, const sptr<IdevicestatusCallback>& callback,
+        DevicestatusTypeTable<int32_t>& results) override;
+    int32_t UnSubscribeTypes(uint32_t typeMask, const sptr<IdevicestatusCallback>& callback,
+        DevicestatusTypeTable<int32_t>& results) override;
+    int32_t GetSnapshot(uint32_t typeMask, DevicestatusTypeTable<DevicestatusLatestState::Entry>& entries) override;
+    int32_t RegisterEventRing(const sptr<IdevicestatusCallback>& callback, const sptr<Ashmem>& memory,
+        int32_t doorbellFd) override;
+    int32_t UnregisterEventRing(const sptr<IdevicestatusCallback>& callback) override;
     bool IsServiceReady();
     std::shared_ptr<DevicestatusManager> GetDevicestatusManager();
 private:
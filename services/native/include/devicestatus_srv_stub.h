@@ -34,6 +34,10 @@ private:
     int32_t SubscribeStub(MessageParcel& data);
     int32_t UnSubscribeStub(MessageParcel& data);
     int32_t GetLatestDevicestatusDataStub(MessageParcel& data, MessageParcel& reply);
+    int32_t SubscribeTypesStub(uint32_t code, MessageParcel& data, MessageParcel& reply);
+    int32_t GetSnapshotStub(MessageParcel& data, MessageParcel& reply);
+    int32_t RegisterEventRingStub(MessageParcel& data, MessageParcel& reply);
+    int32_t UnregisterEventRingStub(MessageParcel& data, MessageParcel& reply);
 };
 } // namespace Msdp
 } // namespace OHOS
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DEVICESTATUS_SUBSCRIBER_H
+#define DEVICESTATUS_SUBSCRIBER_H
+
+#include <array>
+#include <ashmem.h>
+#include <atomic>
+#include <mutex>
+#include <nocopyable.h>
+
+#include "idevicestatus_callback.h"
+#include "devicestatus_data_utils.h"
+#include "devicestatus_event_ring.h"
+#include "devicestatus_type_table.h"
+
+namespace OHOS {
+namespace Msdp {
+/*
+ * Delivery state of one remote callback. Pending events are kept in arrival order with at most one entry
+ * per type: a newer value of a type that is still queued replaces the older one in place, so the backlog
+ * of a slow client is bounded by the number of types. A client that registered an event ring receives its
+ * events through the shared memory ring instead of one binder transaction each, with one doorbell per burst.
+ */
+class DevicestatusSubscriber {
+public:
+    static constexpr size_t TYPE_COUNT = DEVICESTATUS_TYPE_COUNT;
+
+    struct Stats {
+        uint64_t delivered = 0;
+        uint64_t coalesced = 0;
+        uint64_t dropped = 0;
+        size_t pending = 0;
+        uint64_t ringed = 0;
+        uint64_t ringFull = 0;
+    };
+
+    explicit DevicestatusSubscriber(const sptr<IdevicestatusCallback>& callback) : callback_(callback) {}
+    ~DevicestatusSubscriber();
+    DISALLOW_COPY_AND_MOVE(DevicestatusSubscriber);
+
+    // Returns true when the caller has to schedule this subscriber for delivery.
+    bool Push(const DevicestatusDataUtils::DevicestatusData& data);
+    // Delivers at most one event per type; returns true when more events arrived meanwhile.
+    bool Drain();
+    void Close();
+    // Takes ownership of doorbellFd; returns false when the memory does not hold a valid ring.
+    bool AttachRing(const sptr<Ashmem>& memory, int32_t doorbellFd);
+    // Goes back to binder delivery; events already in the ring stay there for the client to read.
+    bool DetachRing();
+    // A client that set up an event ring asked for the low latency path.
+    bool HasRing() const;
+    Stats GetStats() const;
+    const sptr<IdevicestatusCallback>& GetCallback() const
+    {
+        return callback_;
+    }
+
+private:
+    void Deliver(const DevicestatusDataUtils::DevicestatusData& data, bool& ringDoorbell);
+    void RingDoorbell();
+    void ReleaseRingLocked();
+
+    const sptr<IdevicestatusCallback> callback_;
+    mutable std::mutex mutex_;
+    DevicestatusTypeTable<DevicestatusDataUtils::DevicestatusData> values_;
+    DevicestatusTypeTable<bool> queued_;
+    std::array<DevicestatusDataUtils::DevicestatusType, TYPE_COUNT> order_ {};
+    size_t head_ = 0;
+    size_t size_ = 0;
+    bool scheduled_ = false;
+    bool closed_ = false;
+    std::atomic<uint64_t> delivered_ {0};
+    uint64_t coalesced_ = 0;
+    uint64_t dropped_ = 0;
+    // The ring can be attached and detached at any time, so the draining worker writes it under ringMutex_.
+    mutable std::mutex ringMutex_;
+    sptr<Ashmem> ringMemory_;
+    int32_t doorbellFd_ = -1;
+    DevicestatusEventRing ring_;
+    bool ringAttached_ = false;
+    std::atomic<uint64_t> ringed_ {0};
+    std::atomic<uint64_t> ringFull_ {0};
+};
+} // namespace Msdp
+} // namespace OHOS
+#endif // DEVICESTATUS_SUBSCRIBER_H
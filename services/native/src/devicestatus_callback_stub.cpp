@@ -54,8 +54,26 @@ int32_t DevicestatusCallbackStub::OnDevicestatusChangedStub(MessageParcel& data)
         static_cast<DevicestatusDataUtils::DevicestatusType>(type),
         static_cast<DevicestatusDataUtils::DevicestatusValue>(value)
     };
+    ReadDataExtension(data, devicestatusData);
     OnDevicestatusChanged(devicestatusData);
     return ERR_OK;
 }
+
+void DevicestatusCallbackStub::ReadDataExtension(MessageParcel& data,
+    DevicestatusDataUtils::DevicestatusData& devicestatusData)
+{
+    // Older proxies send only type and value.
+    if (data.GetReadableBytes() < sizeof(int32_t)) {
+        return;
+    }
+    int32_t version = 0;
+    DEVICESTATUS_READ_PARCEL_NO_RET(data, Int32, version);
+    if (version < DevicestatusDataUtils::DATA_EXTENSION_VERSION) {
+        return;
+    }
+    DEVICESTATUS_READ_PARCEL_NO_RET(data, Int64, devicestatusData.timestamp);
+    DEVICESTATUS_READ_PARCEL_NO_RET(data, Uint64, devicestatusData.sequence);
+    DEVICESTATUS_READ_PARCEL_NO_RET(data, Int32, devicestatusData.sourceId);
+}
 } // namespace Msdp
 } // namespace OHOS
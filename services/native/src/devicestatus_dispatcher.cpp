@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "devicestatus_dispatcher.h"
+
+#include <pthread.h>
+#include <string>
+
+#include "devicestatus_common.h"
+
+namespace OHOS {
+namespace Msdp {
+DevicestatusDispatcher::~DevicestatusDispatcher()
+{
+    Stop();
+}
+
+bool DevicestatusDispatcher::Start(const FanoutHandler& handler, size_t workerCount, size_t capacity)
+{
+    DEV_HILOGI(SERVICE, "Enter");
+    if ((handler == nullptr) || (workerCount == 0) || (capacity <= DEVICESTATUS_TYPE_COUNT)) {
+        DEV_HILOGE(SERVICE, "invalid dispatcher parameter");
+        return false;
+    }
+    if (running_.load()) {
+        DEV_HILOGI(SERVICE, "dispatcher is already running");
+        return true;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        handler_ = handler;
+        ring_.assign(capacity, DevicestatusDataUtils::DevicestatusData {});
+        head_ = 0;
+        size_ = 0;
+        queued_.Fill(0);
+        ready_.clear();
+    }
+    running_.store(true);
+    fanout_ = std::thread(&DevicestatusDispatcher::FanoutEntry, this);
+    for (size_t i = 0; i < workerCount; ++i) {
+        workers_.emplace_back(&DevicestatusDispatcher::WorkerEntry, this, i);
+    }
+    DEV_HILOGI(SERVICE, "dispatcher started, workers: %{public}zu, capacity: %{public}zu", workerCount, capacity);
+    return true;
+}
+
+void DevicestatusDispatcher::Stop()
+{
+    if (!running_.exchange(false)) {
+        return;
+    }
+    DEV_HILOGI(SERVICE, "Enter");
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ready_.clear();
+    }
+    eventCond_.notify_all();
+    cond_.notify_all();
+    if (fanout_.joinable()) {
+        fanout_.join();
+    }
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers_.clear();
+    DEV_HILOGI(SERVICE, "Exit");
+}
+
+bool DevicestatusDispatcher::IsRunning() const
+{
+    return running_.load();
+}
+
+bool DevicestatusDispatcher::Dispatch(const DevicestatusDataUtils::DevicestatusData& data)
+{
+    if (!running_.load()) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t capacity = ring_.size();
+        if (size_ == capacity) {
+            EvictLocked(FindEvictableLocked(data));
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+        ring_[(head_ + size_) % capacity] = data;
+        ++size_;
+        size_t* queued = queued_.Find(data.type);
+        if (queued != nullptr) {
+            ++*queued;
+        }
+    }
+    eventCond_.notify_one();
+    return true;
+}
+
+void DevicestatusDispatcher::Schedule(const std::shared_ptr<DevicestatusSubscriber>& subscriber)
+{
+    if (subscriber == nullptr) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ready_.push_back(subscriber);
+    }
+    cond_.notify_one();
+}
+
+size_t DevicestatusDispatcher::GetQueueDepth() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return size_;
+}
+
+size_t DevicestatusDispatcher::GetReadyCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ready_.size();
+}
+
+uint64_t DevicestatusDispatcher::GetDroppedCount() const
+{
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+size_t DevicestatusDispatcher::FindEvictableLocked(const DevicestatusDataUtils::DevicestatusData& data) const
+{
+    // The ring holds more events than there are types, so some type always has a newer event queued.
+    for (size_t offset = 0; offset < size_; ++offset) {
+        DevicestatusDataUtils::DevicestatusType type = ring_[(head_ + offset) % ring_.size()].type;
+        const size_t* queued = queued_.Find(type);
+        if ((queued == nullptr) || (*queued > 1) || (type == data.type)) {
+            return offset;
+        }
+    }
+    return 0;
+}
+
+void DevicestatusDispatcher::EvictLocked(size_t offset)
+{
+    size_t capacity = ring_.size();
+    size_t* queued = queued_.Find(ring_[(head_ + offset) % capacity].type);
+    if (queued != nullptr) {
+        --*queued;
+    }
+    // Shift the older events up by one slot to close the gap, keeping their order.
+    for (size_t i = offset; i > 0; --i) {
+        ring_[(head_ + i) % capacity] = ring_[(head_ + i - 1) % capacity];
+    }
+    head_ = (head_ + 1) % capacity;
+    --size_;
+}
+
+void DevicestatusDispatcher::FanoutEntry()
+{
+    pthread_setname_np(pthread_self(), "DevStatusFanout");
+    while (true) {
+        DevicestatusDataUtils::DevicestatusData data;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            eventCond_.wait(lock, [this] { return (size_ != 0) || !running_.load(); });
+            if (!running_.load()) {
+                return;
+            }
+            data = ring_[head_];
+            head_ = (head_ + 1) % ring_.size();
+            --size_;
+            size_t* queued = queued_.Find(data.type);
+            if (queued != nullptr) {
+                --*queued;
+            }
+        }
+        // One thread pushes every event, so a mailbox always holds the newest value of each type.
+        handler_(data);
+    }
+}
+
+void DevicestatusDispatcher::WorkerEntry(size_t index)
+{
+    std::string name = "DevStatusDisp" + std::to_string(index);
+    pthread_setname_np(pthread_self(), name.c_str());
+    while (true) {
+        std::shared_ptr<DevicestatusSubscriber> subscriber = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cond_.wait(lock, [this] { return !ready_.empty() || !running_.load(); });
+            if (!running_.load()) {
+                return;
+            }
+            subscriber = ready_.front();
+            ready_.pop_front();
+        }
+        if (subscriber->Drain()) {
+            Schedule(subscriber);
+        }
+    }
+}
+} // namespace Msdp
+} // namespace OHOS
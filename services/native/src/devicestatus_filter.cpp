@@ -0,0 +1,358 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "devicestatus_filter.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+#include "json/json.h"
+
+#include "devicestatus_common.h"
+
+namespace OHOS {
+namespace Msdp {
+namespace {
+constexpr int64_t NS_PER_MS = 1000000;
+constexpr double NS_PER_SECOND = 1000000000.0;
+constexpr size_t DUMP_LINE_SIZE = 160;
+
+bool ParseType(const Json::Value& value, DevicestatusDataUtils::DevicestatusType& type)
+{
+    if (value.isString()) {
+        for (size_t i = 0; i < DEVICESTATUS_TYPE_COUNT; ++i) {
+            if (value.asString() == DEVICESTATUS_TYPE_NAMES[i]) {
+                type = DevicestatusTypeTable<int32_t>::TypeAt(i);
+                return true;
+            }
+        }
+        return false;
+    }
+    if (!value.isInt()) {
+        return false;
+    }
+    type = static_cast<DevicestatusDataUtils::DevicestatusType>(value.asInt());
+    return IsValidDevicestatusType(type);
+}
+
+bool ParseField(const Json::Value& entry, const char* name, uint32_t& field)
+{
+    const Json::Value& value = entry[name];
+    if (value.isNull()) {
+        return true;
+    }
+    if (!value.isUInt()) {
+        return false;
+    }
+    field = value.asUInt();
+    return true;
+}
+}
+
+DevicestatusFilter::~DevicestatusFilter()
+{
+    // A filter with static storage duration may outlive the reactor, so the timer is not removed here.
+    if (running_.load()) {
+        DEV_HILOGE(SERVICE, "filter destroyed without Stop()");
+    }
+}
+
+bool DevicestatusFilter::Start(const CommitHandler& handler)
+{
+    DEV_HILOGI(SERVICE, "Enter");
+    if (handler == nullptr) {
+        DEV_HILOGE(SERVICE, "invalid commit handler");
+        return false;
+    }
+    if (running_.load()) {
+        DEV_HILOGI(SERVICE, "filter is already running");
+        return true;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        handler_ = handler;
+    }
+    timerId_ = DevicestatusReactor::GetInstance().AddTimer("filter", [this] { OnTimer(); });
+    if (timerId_ == DevicestatusReactor::INVALID_ID) {
+        DEV_HILOGE(SERVICE, "add filter timer failed");
+        return false;
+    }
+    running_.store(true);
+    return DevicestatusReactor::GetInstance().Start();
+}
+
+void DevicestatusFilter::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_.exchange(false)) {
+            return;
+        }
+        // Transitions that have not settled yet are dropped with the pipeline they would go to.
+        for (auto& state : states_) {
+            state.pending = false;
+        }
+        armedDeadline_ = 0;
+    }
+    DEV_HILOGI(SERVICE, "Enter");
+    // Outside mutex_: Remove() waits for a running OnTimer(), which takes it.
+    DevicestatusReactor::GetInstance().Remove(timerId_);
+    timerId_ = DevicestatusReactor::INVALID_ID;
+}
+
+int32_t DevicestatusFilter::SetConfig(DevicestatusDataUtils::DevicestatusType type, const Config& config)
+{
+    State* state = states_.Find(type);
+    if (state == nullptr) {
+        DEV_HILOGE(SERVICE, "invalid type: %{public}d", type);
+        return E_DEVICESTATUS_INVALID_TYPE;
+    }
+    if ((config.enterDwellMs > MAX_DWELL_MS) || (config.exitDwellMs > MAX_DWELL_MS) ||
+        (config.maxPerSecond > MAX_PER_SECOND)) {
+        DEV_HILOGE(SERVICE, "filter config out of range");
+        return ERR_INVALID_VALUE;
+    }
+    DEV_HILOGI(SERVICE, "type: %{public}d, enterDwell: %{public}u, exitDwell: %{public}u, maxPerSecond: %{public}u",
+        type, config.enterDwellMs, config.exitDwellMs, config.maxPerSecond);
+    std::lock_guard<std::mutex> lock(mutex_);
+    int64_t now = DevicestatusGetBootTime();
+    state->config = config;
+    state->tokens = config.maxPerSecond;
+    state->refillTime = now;
+    state->unfiltered.store(config.IsPassThrough() && !state->pending && (state->inflight == 0));
+    if (state->pending && running_.load()) {
+        state->deadline = std::max(state->pendingTime + GetDwell(*state, state->pendingData.value), now);
+        ScheduleLocked(state->deadline, now);
+    }
+    return ERR_OK;
+}
+
+int32_t DevicestatusFilter::LoadConfig(const std::string& path)
+{
+    DEV_HILOGI(SERVICE, "Enter");
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        DEV_HILOGI(SERVICE, "no filter config, every type passes through");
+        return ERR_OK;
+    }
+    Json::CharReaderBuilder builder;
+    Json::Value root;
+    std::string errors;
+    if (!Json::parseFromStream(builder, file, &root, &errors) || !root.isObject() || !root["filters"].isArray()) {
+        DEV_HILOGE(SERVICE, "invalid filter config: %{public}s", errors.c_str());
+        return ERR_INVALID_VALUE;
+    }
+    int32_t ret = ERR_OK;
+    for (const Json::Value& entry : root["filters"]) {
+        DevicestatusDataUtils::DevicestatusType type;
+        Config config;
+        if (!entry.isObject() || !ParseType(entry["type"], type) ||
+            !ParseField(entry, "enterDwellMs", config.enterDwellMs) ||
+            !ParseField(entry, "exitDwellMs", config.exitDwellMs) ||
+            !ParseField(entry, "maxPerSecond", config.maxPerSecond)) {
+            DEV_HILOGE(SERVICE, "skip invalid filter config entry");
+            ret = ERR_INVALID_VALUE;
+            continue;
+        }
+        int32_t result = SetConfig(type, config);
+        if (result != ERR_OK) {
+            ret = result;
+        }
+    }
+    return ret;
+}
+
+DevicestatusFilter::Config DevicestatusFilter::GetConfig(DevicestatusDataUtils::DevicestatusType type)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const State* state = states_.Find(type);
+    return (state != nullptr) ? state->config : Config {};
+}
+
+DevicestatusFilter::Stats DevicestatusFilter::GetStats(DevicestatusDataUtils::DevicestatusType type)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const State* state = states_.Find(type);
+    if (state == nullptr) {
+        return {};
+    }
+    Stats stats = state->stats;
+    stats.passed = state->passed.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool DevicestatusFilter::Filter(const DevicestatusDataUtils::DevicestatusData& data)
+{
+    State* state = states_.Find(data.type);
+    if (state == nullptr) {
+        return true;
+    }
+    if (state->unfiltered.load()) {
+        state->committed.store(true, std::memory_order_relaxed);
+        state->value.store(data.value, std::memory_order_relaxed);
+        state->passed.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool settled = !state->pending && (state->inflight == 0);
+    if ((state->config.IsPassThrough() && settled) || !running_.load()) {
+        state->pending = false;
+        state->committed.store(true, std::memory_order_relaxed);
+        state->value.store(data.value, std::memory_order_relaxed);
+        state->passed.fetch_add(1, std::memory_order_relaxed);
+        // Settled again after a filtered stretch, the following events can skip mutex_.
+        state->unfiltered.store(state->config.IsPassThrough() && settled);
+        return true;
+    }
+    if (state->committed.load(std::memory_order_relaxed) &&
+        (data.value == state->value.load(std::memory_order_relaxed))) {
+        // Back to the committed value before the transition settled: the whole flap is suppressed.
+        if (state->pending) {
+            state->pending = false;
+            state->stats.suppressed++;
+        }
+        return false;
+    }
+    if (state->pending) {
+        if (state->pendingData.value == data.value) {
+            // Still settling; the dwell time counts from the first report of the value.
+            return false;
+        }
+        state->stats.suppressed++;
+    }
+    int64_t now = DevicestatusGetBootTime();
+    state->pending = true;
+    state->pendingData = data;
+    state->pendingTime = now;
+    state->deadline = std::max(now + GetDwell(*state, data.value), GetTokenTime(*state, now));
+    ScheduleLocked(state->deadline, now);
+    return false;
+}
+
+void DevicestatusFilter::Dump(std::string& out)
+{
+    char line[DUMP_LINE_SIZE];
+    std::lock_guard<std::mutex> lock(mutex_);
+    out.append("filter:\n");
+    for (size_t i = 0; i < DEVICESTATUS_TYPE_COUNT; ++i) {
+        const State& state = states_[DevicestatusTypeTable<int32_t>::TypeAt(i)];
+        int32_t len = snprintf(line, sizeof(line),
+            "  %-14s enterDwell=%ums exitDwell=%ums maxRate=%u/s passed=%" PRIu64 " suppressed=%" PRIu64
+            " delayed=%" PRIu64 " pending=%s\n", DEVICESTATUS_TYPE_NAMES[i], state.config.enterDwellMs,
+            state.config.exitDwellMs, state.config.maxPerSecond, state.passed.load(std::memory_order_relaxed),
+            state.stats.suppressed, state.stats.delayed, state.pending ? "yes" : "no");
+        if (len > 0) {
+            out.append(line);
+        }
+    }
+}
+
+int64_t DevicestatusFilter::GetDwell(const State& state, DevicestatusDataUtils::DevicestatusValue value)
+{
+    uint32_t dwellMs = (value == DevicestatusDataUtils::DevicestatusValue::VALUE_ENTER) ?
+        state.config.enterDwellMs : state.config.exitDwellMs;
+    return static_cast<int64_t>(dwellMs) * NS_PER_MS;
+}
+
+void DevicestatusFilter::Refill(State& state, int64_t now)
+{
+    double rate = state.config.maxPerSecond;
+    if ((rate <= 0.0) || (now <= state.refillTime)) {
+        return;
+    }
+    state.tokens = std::min(rate, state.tokens + (now - state.refillTime) / NS_PER_SECOND * rate);
+    state.refillTime = now;
+}
+
+int64_t DevicestatusFilter::GetTokenTime(State& state, int64_t now)
+{
+    if (state.config.maxPerSecond == 0) {
+        return now;
+    }
+    Refill(state, now);
+    if (state.tokens >= 1.0) {
+        return now;
+    }
+    // Rounded up so that the token is really there when the timer fires.
+    return now + static_cast<int64_t>((1.0 - state.tokens) / state.config.maxPerSecond * NS_PER_SECOND) + 1;
+}
+
+void DevicestatusFilter::ScheduleLocked(int64_t deadline, int64_t now)
+{
+    // The timer only ever moves earlier here, OnTimer() rearms it for the next deadline when it fires.
+    if ((armedDeadline_ != 0) && (armedDeadline_ <= deadline)) {
+        return;
+    }
+    armedDeadline_ = deadline;
+    DevicestatusReactor::GetInstance().ArmTimer(timerId_, deadline - now);
+}
+
+void DevicestatusFilter::OnTimer()
+{
+    std::vector<DevicestatusDataUtils::DevicestatusData> commits;
+    std::unique_lock<std::mutex> lock(mutex_);
+    armedDeadline_ = 0;
+    while (running_.load()) {
+        int64_t now = DevicestatusGetBootTime();
+        int64_t next = std::numeric_limits<int64_t>::max();
+        commits.clear();
+        for (auto& state : states_) {
+            if (!state.pending) {
+                continue;
+            }
+            if (state.deadline > now) {
+                next = std::min(next, state.deadline);
+                continue;
+            }
+            if (state.config.maxPerSecond != 0) {
+                Refill(state, now);
+                if (state.tokens < 1.0) {
+                    state.deadline = GetTokenTime(state, now);
+                    next = std::min(next, state.deadline);
+                    continue;
+                }
+                state.tokens -= 1.0;
+            }
+            state.pending = false;
+            state.committed.store(true, std::memory_order_relaxed);
+            state.value.store(state.pendingData.value, std::memory_order_relaxed);
+            state.passed.fetch_add(1, std::memory_order_relaxed);
+            state.stats.delayed += (state.deadline > state.pendingTime) ? 1 : 0;
+            state.inflight++;
+            commits.push_back(state.pendingData);
+        }
+        if (!commits.empty()) {
+            lock.unlock();
+            for (const auto& data : commits) {
+                handler_(data);
+            }
+            lock.lock();
+            for (const auto& data : commits) {
+                states_[data.type].inflight--;
+            }
+            continue;
+        }
+        if (next != std::numeric_limits<int64_t>::max()) {
+            ScheduleLocked(next, now);
+        }
+        return;
+    }
+}
+} // namespace Msdp
+} // namespace OHOS
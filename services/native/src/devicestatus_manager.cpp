@@ -15,11 +15,20 @@
 
 #include "devicestatus_manager.h"
 
+#include <cinttypes>
+#include <cstdio>
+#include <unistd.h>
+
+#include "devicestatus_latency_stats.h"
+
 namespace OHOS {
 namespace Msdp {
 namespace {
 constexpr int32_t ERR_OK = 0;
 constexpr int32_t ERR_NG = -1;
+constexpr size_t DUMP_LINE_SIZE = 160;
+constexpr double NS_PER_SECOND = 1000000000.0;
+constexpr const char* SOURCE_NAMES[DevicestatusMsdpClientImpl::SOURCE_MAX] = { "msdp", "sensor" };
 }
 void DevicestatusManager::DevicestatusCallbackDeathRecipient::OnRemoteDied(const wptr<IRemoteObject>& remote)
 {
@@ -28,13 +37,19 @@ void DevicestatusManager::DevicestatusCallbackDeathRecipient::OnRemoteDied(const
         return;
     }
     DEV_HILOGD(SERVICE, "Recv death notice");
+    std::shared_ptr<DevicestatusManager> manager = manager_.lock();
+    if (manager == nullptr) {
+        DEV_HILOGE(SERVICE, "manager is released");
+        return;
+    }
+    manager->ReapDeadSubscriber(remote.promote());
 }
 
 bool DevicestatusManager::Init()
 {
     DEV_HILOGI(SERVICE, "Enter");
     if (devicestatusCBDeathRecipient_ == nullptr) {
-        devicestatusCBDeathRecipient_ = new DevicestatusCallbackDeathRecipient();
+        devicestatusCBDeathRecipient_ = new DevicestatusCallbackDeathRecipient(weak_from_this());
     }
 
     msdpImpl_ = std::make_unique<DevicestatusMsdpClientImpl>();
@@ -42,6 +57,13 @@ bool DevicestatusManager::Init()
         return false;
     }
     LoadAlgorithm(false);
+    dumpedTime_ = DevicestatusGetBootTime();
+
+    DevicestatusDispatcher::FanoutHandler handler =
+        std::bind(&DevicestatusManager::FanoutDevicestatusChange, this, std::placeholders::_1);
+    if (!dispatcher_.Start(handler)) {
+        DEV_HILOGE(SERVICE, "start dispatcher failed, deliver on the producer thread");
+    }
 
     DEV_HILOGI(SERVICE, "Init success");
     return true;
@@ -50,30 +72,41 @@ bool DevicestatusManager::Init()
 DevicestatusDataUtils::DevicestatusData DevicestatusManager::GetLatestDevicestatusData(const \
     DevicestatusDataUtils::DevicestatusType& type)
 {
-    DEV_HILOGI(SERVICE, "Enter");
-    DevicestatusDataUtils::DevicestatusData data = {type, DevicestatusDataUtils::DevicestatusValue::VALUE_EXIT};
+    DevicestatusDataUtils::DevicestatusData data = {type, DevicestatusDataUtils::DevicestatusValue::VALUE_INVALID};
     if (msdpImpl_ == nullptr) {
         DEV_HILOGI(SERVICE, "GetObserverData func is nullptr,return default!");
-        data.value = DevicestatusDataUtils::DevicestatusValue::VALUE_INVALID;
         return data;
     }
-    msdpData_ = msdpImpl_->GetObserverData();
-    for (auto iter = msdpData_.begin(); iter != msdpData_.end(); ++iter) {
-        if (data.type == iter->first) {
-            data.value = iter->second;
-            return data;
-        }
+    DevicestatusLatestState::Entry entry;
+    if (msdpImpl_->GetObserverData(type, entry)) {
+        data.value = entry.value;
+        data.timestamp = entry.timestamp;
+        data.sequence = entry.sequence;
     }
-
-    data.value = DevicestatusDataUtils::DevicestatusValue::VALUE_INVALID;
     return data;
 }
 
-bool DevicestatusManager::EnableRdb()
+int32_t DevicestatusManager::GetLatestDevicestatusSnapshot(uint32_t typeMask,
+    DevicestatusTypeTable<DevicestatusLatestState::Entry>& entries)
+{
+    if (msdpImpl_ == nullptr) {
+        DEV_HILOGE(SERVICE, "msdpImpl_ is nullptr");
+        return E_DEVICESTATUS_INNER_ERR;
+    }
+    for (size_t i = 0; i < DEVICESTATUS_TYPE_COUNT; ++i) {
+        DevicestatusDataUtils::DevicestatusType type = DevicestatusTypeTable<int32_t>::TypeAt(i);
+        if ((typeMask & DevicestatusTypeMask(type)) != 0) {
+            msdpImpl_->GetObserverData(type, entries[type]);
+        }
+    }
+    return ERR_OK;
+}
+
+bool DevicestatusManager::EnableRdb(const DevicestatusDataUtils::DevicestatusType& type)
 {
-    DEV_HILOGE(SERVICE, "Enter");
-    if (!InitInterface()) {
-        DEV_HILOGE(SERVICE, "init interface fail");
+    DEV_HILOGI(SERVICE, "Enter, type: %{public}d", type);
+    if (msdpImpl_ == nullptr) {
+        DEV_HILOGE(SERVICE, "msdpImpl_ is nullptr");
         return false;
     }
 
@@ -81,46 +114,48 @@ bool DevicestatusManager::EnableRdb()
         DEV_HILOGE(SERVICE, "init msdp callback fail");
         return false;
     }
+
+    DevicestatusMsdpClientImpl::SourceType source = DevicestatusMsdpClientImpl::GetSourceType(type);
+    if (sourceRefs_[source]++ > 0) {
+        DEV_HILOGI(SERVICE, "source %{public}d already enabled, refs: %{public}u", source, sourceRefs_[source]);
+        return true;
+    }
+    if (msdpImpl_->EnableSource(source) == ERR_NG) {
+        DEV_HILOGE(SERVICE, "enable source %{public}d failed", source);
+    }
     return true;
 }
 
-bool DevicestatusManager::DisableRdb()
+bool DevicestatusManager::DisableRdb(const DevicestatusDataUtils::DevicestatusType& type)
 {
-    DEV_HILOGE(SERVICE, "Enter");
+    DEV_HILOGI(SERVICE, "Enter, type: %{public}d", type);
     if (msdpImpl_ == nullptr) {
         DEV_HILOGE(SERVICE, "disable rdb failed, msdpImpl is nullptr");
         return false;
     }
 
-    if (msdpImpl_->DisableMsdpImpl() == ERR_NG) {
-        DEV_HILOGE(SERVICE, "disable msdp impl failed");
+    DevicestatusMsdpClientImpl::SourceType source = DevicestatusMsdpClientImpl::GetSourceType(type);
+    if (sourceRefs_[source] == 0) {
+        DEV_HILOGE(SERVICE, "source %{public}d is not enabled", source);
         return false;
     }
-
-    if (msdpImpl_->UnregisterImpl() == ERR_NG) {
-        DEV_HILOGE(SERVICE, "unregister impl failed");
-        return false;
+    if (--sourceRefs_[source] > 0) {
+        DEV_HILOGI(SERVICE, "source %{public}d still in use, refs: %{public}u", source, sourceRefs_[source]);
+        return true;
     }
-
-    return true;
-}
-
-bool DevicestatusManager::InitInterface()
-{
-    DEV_HILOGE(SERVICE, "Enter");
-    if (msdpImpl_ == nullptr) {
-        DEV_HILOGE(SERVICE, "msdpImpl_ is nullptr");
+    if (msdpImpl_->DisableSource(source) == ERR_NG) {
+        DEV_HILOGE(SERVICE, "disable source %{public}d failed", source);
         return false;
     }
-    if (msdpImpl_->InitMsdpImpl() == ERR_NG) {
-        DEV_HILOGE(SERVICE, "init msdp impl failed");
-    };
     return true;
 }
 
 bool DevicestatusManager::InitDataCallback()
 {
-    DEV_HILOGE(SERVICE, "Enter");
+    DEV_HILOGI(SERVICE, "Enter");
+    if (dataCallbackRegistered_) {
+        return true;
+    }
     if (msdpImpl_ == nullptr) {
         DEV_HILOGE(SERVICE, "msdpImpl_ is nullptr");
         return false;
@@ -129,7 +164,9 @@ bool DevicestatusManager::InitDataCallback()
         std::bind(&DevicestatusManager::MsdpDataCallback, this, std::placeholders::_1);
     if (msdpImpl_->RegisterImpl(callback) == ERR_NG) {
         DEV_HILOGE(SERVICE, "register impl failed");
+        return true;
     }
+    dataCallbackRegistered_ = true;
     return true;
 }
 
@@ -149,107 +186,376 @@ int32_t DevicestatusManager::SensorDataCallback(const struct SensorEvents *event
     return ERR_OK;
 }
 
-void DevicestatusManager::NotifyDevicestatusChange(const DevicestatusDataUtils::DevicestatusData& devicestatusData)
+std::shared_ptr<const DevicestatusManager::ListenerSnapshot> DevicestatusManager::GetListenerSnapshot(
+    const DevicestatusDataUtils::DevicestatusType& type) const
 {
-    DEV_HILOGI(SERVICE, "Enter");
+    if (!IsValidDevicestatusType(type)) {
+        return nullptr;
+    }
+    // Takes the library's pointer lock for the copy only, never mutex_ that Subscribe holds across its work.
+    return std::atomic_load(&listenerSnapshots_[type]);
+}
 
-    // Call back for all listeners
-    std::set<const sptr<IdevicestatusCallback>, classcomp> listeners;
-    bool isExists = false;
-    for (auto it = listenerMap_.begin(); it != listenerMap_.end(); ++it) {
-        if (it->first == devicestatusData.type) {
-            isExists = true;
-            listeners = (std::set<const sptr<IdevicestatusCallback>, classcomp>)(it->second);
-            break;
+void DevicestatusManager::PublishListenerSnapshot(const DevicestatusDataUtils::DevicestatusType& type)
+{
+    if (!IsValidDevicestatusType(type)) {
+        return;
+    }
+    std::shared_ptr<ListenerSnapshot> snapshot = nullptr;
+    const auto& listeners = listenerMap_[type];
+    if (!listeners.empty()) {
+        snapshot = std::make_shared<ListenerSnapshot>();
+        snapshot->reserve(listeners.size());
+        for (const auto& listener : listeners) {
+            auto recordIter = subscribers_.find(listener->AsObject());
+            if (recordIter != subscribers_.end()) {
+                snapshot->push_back(recordIter->second.subscriber);
+            }
         }
     }
-    if (!isExists) {
-        DEV_HILOGI(SERVICE, "No listener found for type: %{public}d", \
-            devicestatusData.type);
-        DEV_HILOGI(SERVICE, "Exit");
+    std::atomic_store(&listenerSnapshots_[type], std::shared_ptr<const ListenerSnapshot>(snapshot));
+}
+
+void DevicestatusManager::NotifyDevicestatusChange(const DevicestatusDataUtils::DevicestatusData& devicestatusData)
+{
+    DEV_HILOGD(SERVICE, "Enter");
+    DevicestatusLatencyStats::GetInstance().RecordSince(DevicestatusLatencyStats::HOP_SOURCE_TO_NOTIFY,
+        devicestatusData);
+    std::atomic<uint64_t>* eventCount = eventCounts_.Find(devicestatusData.type);
+    if (eventCount != nullptr) {
+        eventCount->fetch_add(1, std::memory_order_relaxed);
+    }
+    std::shared_ptr<const ListenerSnapshot> listeners = GetListenerSnapshot(devicestatusData.type);
+    if (listeners == nullptr) {
+        DEV_HILOGD(SERVICE, "No listener found for type: %{public}d", devicestatusData.type);
+        return;
+    }
+    if (dispatcher_.Dispatch(devicestatusData)) {
+        return;
+    }
+    for (const auto& subscriber : *listeners) {
+        subscriber->GetCallback()->OnDevicestatusChanged(devicestatusData);
+    }
+}
+
+void DevicestatusManager::FanoutDevicestatusChange(const DevicestatusDataUtils::DevicestatusData& devicestatusData)
+{
+    std::shared_ptr<const ListenerSnapshot> listeners = GetListenerSnapshot(devicestatusData.type);
+    if (listeners == nullptr) {
         return;
     }
-    for (auto& listener : listeners) {
-        if (listener == nullptr) {
-            DEV_HILOGI(SERVICE, "Listener is nullptr");
-            return;
+    for (const auto& subscriber : *listeners) {
+        if (subscriber->Push(devicestatusData)) {
+            dispatcher_.Schedule(subscriber);
         }
-        listener->OnDevicestatusChanged(devicestatusData);
     }
 }
 
-void DevicestatusManager::Subscribe(const DevicestatusDataUtils::DevicestatusType& type,
-    const sptr<IdevicestatusCallback>& callback)
+DevicestatusSubscriber::Stats DevicestatusManager::GetDeliveryStats()
 {
-    DEV_HILOGI(SERVICE, "Enter");
-    DEVICESTATUS_RETURN_IF(callback == nullptr);
-    auto object = callback->AsObject();
-    DEVICESTATUS_RETURN_IF(object == nullptr);
-    std::set<const sptr<IdevicestatusCallback>, classcomp> listeners;
-    DEV_HILOGI(SERVICE, "listenerMap_.size=%{public}zu", listenerMap_.size());
+    std::lock_guard lock(mutex_);
+    DevicestatusSubscriber::Stats total = retiredStats_;
+    for (const auto& record : subscribers_) {
+        DevicestatusSubscriber::Stats stats = record.second.subscriber->GetStats();
+        total.delivered += stats.delivered;
+        total.coalesced += stats.coalesced;
+        total.dropped += stats.dropped;
+        total.pending += stats.pending;
+        total.ringed += stats.ringed;
+        total.ringFull += stats.ringFull;
+    }
+    total.dropped += dispatcher_.GetDroppedCount();
+    return total;
+}
 
-    if (!EnableRdb()) {
-        DEV_HILOGE(SERVICE, "Enable failed!");
-        return;
+uint64_t DevicestatusManager::GetReapedCount()
+{
+    std::lock_guard lock(mutex_);
+    return reapedCount_;
+}
+
+void DevicestatusManager::StopFilter()
+{
+    if (msdpImpl_ != nullptr) {
+        msdpImpl_->StopFilter();
     }
+}
 
+void DevicestatusManager::Dump(std::string& out)
+{
+    DevicestatusSubscriber::Stats stats = GetDeliveryStats();
+    char line[DUMP_LINE_SIZE];
     std::lock_guard lock(mutex_);
-    auto dtTypeIter = listenerMap_.find(type);
-    if (dtTypeIter == listenerMap_.end()) {
-        if (listeners.insert(callback).second) {
-            DEV_HILOGI(SERVICE, "no found set list of type, insert success");
-            object->AddDeathRecipient(devicestatusCBDeathRecipient_);
+    int64_t now = DevicestatusGetBootTime();
+    double elapsed = (now > dumpedTime_) ? ((now - dumpedTime_) / NS_PER_SECOND) : 0.0;
+    out.append("types:\n");
+    for (size_t i = 0; i < DEVICESTATUS_TYPE_COUNT; ++i) {
+        DevicestatusDataUtils::DevicestatusType type = DevicestatusTypeTable<int32_t>::TypeAt(i);
+        uint64_t events = eventCounts_[type].load(std::memory_order_relaxed);
+        double rate = (elapsed > 0.0) ? ((events - dumpedEventCounts_[type]) / elapsed) : 0.0;
+        dumpedEventCounts_[type] = events;
+        int32_t len = snprintf(line, sizeof(line), "  %-14s subscribers=%zu events=%" PRIu64 " rate=%.2f/s\n",
+            DEVICESTATUS_TYPE_NAMES[i], listenerMap_[type].size(), events, rate);
+        if (len > 0) {
+            out.append(line);
         }
-        listenerMap_.insert(std::make_pair(type, listeners));
-    } else {
-        DEV_HILOGI(SERVICE, "callbacklist.size=%{public}zu",
-            listenerMap_[dtTypeIter->first].size());
-        auto iter = listenerMap_[dtTypeIter->first].find(callback);
-        if (iter != listenerMap_[dtTypeIter->first].end()) {
-            return;
-        } else {
-            if (listenerMap_[dtTypeIter->first].insert(callback).second) {
-                DEV_HILOGI(SERVICE, "found set list of type, insert success");
-                object->AddDeathRecipient(devicestatusCBDeathRecipient_);
-            }
+    }
+    dumpedTime_ = now;
+    out.append("sources:");
+    for (size_t source = 0; source < DevicestatusMsdpClientImpl::SOURCE_MAX; ++source) {
+        int32_t len = snprintf(line, sizeof(line), " %s=%s(refs=%u%s)", SOURCE_NAMES[source],
+            (sourceRefs_[source] > 0) ? "enabled" : "disabled", sourceRefs_[source],
+            lowLatencySources_[source] ? ",lowLatency" : "");
+        if (len > 0) {
+            out.append(line);
         }
     }
-    DEV_HILOGI(SERVICE, "Subscribe success,Exit");
+    out.append("\n");
+    int32_t len = snprintf(line, sizeof(line),
+        "delivery: subscribers=%zu delivered=%" PRIu64 " coalesced=%" PRIu64 " dropped=%" PRIu64
+        " pending=%zu reaped=%" PRIu64 " ringed=%" PRIu64 " ringFull=%" PRIu64 "\n", subscribers_.size(),
+        stats.delivered, stats.coalesced, stats.dropped, stats.pending, reapedCount_, stats.ringed, stats.ringFull);
+    if (len > 0) {
+        out.append(line);
+    }
+    len = snprintf(line, sizeof(line), "dispatcher: running=%s queue=%zu ready=%zu dropped=%" PRIu64 "\n",
+        dispatcher_.IsRunning() ? "yes" : "no", dispatcher_.GetQueueDepth(), dispatcher_.GetReadyCount(),
+        dispatcher_.GetDroppedCount());
+    if (len > 0) {
+        out.append(line);
+    }
+    if (msdpImpl_ != nullptr) {
+        msdpImpl_->Dump(out);
+    }
+}
+
+int32_t DevicestatusManager::AttachEventRing(const sptr<IdevicestatusCallback>& callback, const sptr<Ashmem>& memory,
+    int32_t doorbellFd)
+{
+    DEV_HILOGI(SERVICE, "Enter");
+    if ((callback == nullptr) || (callback->AsObject() == nullptr)) {
+        DEV_HILOGE(SERVICE, "callback is nullptr");
+        close(doorbellFd);
+        return E_DEVICESTATUS_READ_PARCEL_ERROR;
+    }
+    std::lock_guard lock(mutex_);
+    auto recordIter = subscribers_.find(callback->AsObject());
+    if (recordIter == subscribers_.end()) {
+        DEV_HILOGE(SERVICE, "callback has no subscription");
+        close(doorbellFd);
+        return E_DEVICESTATUS_NOT_SUBSCRIBED;
+    }
+    if (!recordIter->second.subscriber->AttachRing(memory, doorbellFd)) {
+        return E_DEVICESTATUS_INNER_ERR;
+    }
+    UpdateSourceLatency();
+    DEV_HILOGI(SERVICE, "Exit");
+    return ERR_OK;
+}
+
+int32_t DevicestatusManager::DetachEventRing(const sptr<IdevicestatusCallback>& callback)
+{
+    DEV_HILOGI(SERVICE, "Enter");
+    DEVICESTATUS_RETURN_IF_WITH_RET((callback == nullptr) || (callback->AsObject() == nullptr),
+        E_DEVICESTATUS_READ_PARCEL_ERROR);
+    std::lock_guard lock(mutex_);
+    auto recordIter = subscribers_.find(callback->AsObject());
+    if (recordIter == subscribers_.end()) {
+        DEV_HILOGE(SERVICE, "callback has no subscription");
+        return E_DEVICESTATUS_NOT_SUBSCRIBED;
+    }
+    if (!recordIter->second.subscriber->DetachRing()) {
+        DEV_HILOGI(SERVICE, "no event ring attached");
+    }
+    UpdateSourceLatency();
+    DEV_HILOGI(SERVICE, "Exit");
+    return ERR_OK;
+}
+
+void DevicestatusManager::Subscribe(const DevicestatusDataUtils::DevicestatusType& type,
+    const sptr<IdevicestatusCallback>& callback)
+{
+    DEV_HILOGI(SERVICE, "Enter");
+    DEVICESTATUS_RETURN_IF((callback == nullptr) || (callback->AsObject() == nullptr));
+    std::lock_guard lock(mutex_);
+    SubscribeLocked(type, callback);
+    DEV_HILOGI(SERVICE, "Exit");
 }
 
 void DevicestatusManager::UnSubscribe(const DevicestatusDataUtils::DevicestatusType& type,
     const sptr<IdevicestatusCallback>& callback)
 {
     DEV_HILOGI(SERVICE, "Enter");
+    DEVICESTATUS_RETURN_IF((callback == nullptr) || (callback->AsObject() == nullptr));
+    std::lock_guard lock(mutex_);
+    UnSubscribeLocked(type, callback);
+    DEV_HILOGI(SERVICE, "Exit");
+}
+
+int32_t DevicestatusManager::SubscribeTypes(uint32_t typeMask, const sptr<IdevicestatusCallback>& callback,
+    DevicestatusTypeTable<int32_t>& results)
+{
+    DEV_HILOGI(SERVICE, "Enter, typeMask: 0x%{public}x", typeMask);
+    DEVICESTATUS_RETURN_IF_WITH_RET((callback == nullptr) || (callback->AsObject() == nullptr),
+        E_DEVICESTATUS_READ_PARCEL_ERROR);
+    std::lock_guard lock(mutex_);
+    for (size_t i = 0; i < DEVICESTATUS_TYPE_COUNT; ++i) {
+        DevicestatusDataUtils::DevicestatusType type = DevicestatusTypeTable<int32_t>::TypeAt(i);
+        if ((typeMask & DevicestatusTypeMask(type)) != 0) {
+            results[type] = SubscribeLocked(type, callback);
+        }
+    }
+    DEV_HILOGI(SERVICE, "Exit");
+    return ERR_OK;
+}
+
+int32_t DevicestatusManager::UnSubscribeTypes(uint32_t typeMask, const sptr<IdevicestatusCallback>& callback,
+    DevicestatusTypeTable<int32_t>& results)
+{
+    DEV_HILOGI(SERVICE, "Enter, typeMask: 0x%{public}x", typeMask);
+    DEVICESTATUS_RETURN_IF_WITH_RET((callback == nullptr) || (callback->AsObject() == nullptr),
+        E_DEVICESTATUS_READ_PARCEL_ERROR);
     std::lock_guard lock(mutex_);
-    DEVICESTATUS_RETURN_IF(callback == nullptr);
+    for (size_t i = 0; i < DEVICESTATUS_TYPE_COUNT; ++i) {
+        DevicestatusDataUtils::DevicestatusType type = DevicestatusTypeTable<int32_t>::TypeAt(i);
+        if ((typeMask & DevicestatusTypeMask(type)) != 0) {
+            results[type] = UnSubscribeLocked(type, callback);
+        }
+    }
+    DEV_HILOGI(SERVICE, "Exit");
+    return ERR_OK;
+}
+
+int32_t DevicestatusManager::SubscribeLocked(const DevicestatusDataUtils::DevicestatusType& type,
+    const sptr<IdevicestatusCallback>& callback)
+{
+    if (!IsValidDevicestatusType(type)) {
+        DEV_HILOGE(SERVICE, "invalid type: %{public}d", type);
+        return E_DEVICESTATUS_INVALID_TYPE;
+    }
+    auto& listeners = listenerMap_[type];
+    if (!listeners.insert(callback).second) {
+        DEV_HILOGI(SERVICE, "callback already subscribed to type: %{public}d", type);
+        return ERR_OK;
+    }
+    // The first subscriber of a type starts the source behind it.
+    if ((listeners.size() == 1) && !EnableRdb(type)) {
+        DEV_HILOGE(SERVICE, "Enable failed!");
+        listeners.clear();
+        return E_DEVICESTATUS_INNER_ERR;
+    }
     auto object = callback->AsObject();
-    DEVICESTATUS_RETURN_IF(object == nullptr);
-    DEV_HILOGI(SERVICE, "listenerMap_.size=%{public}zu", listenerMap_.size());
+    auto recordIter = subscribers_.find(object);
+    if (recordIter == subscribers_.end()) {
+        SubscriptionRecord record;
+        record.subscriber = std::make_shared<DevicestatusSubscriber>(callback);
+        recordIter = subscribers_.emplace(object, record).first;
+        // One death recipient per client, however many types it subscribes to.
+        object->AddDeathRecipient(devicestatusCBDeathRecipient_);
+    }
+    recordIter->second.types.insert(type);
+    DEV_HILOGI(SERVICE, "%{public}s callbacklist.size=%{public}zu", GetDevicestatusTypeName(type), listeners.size());
+    PublishListenerSnapshot(type);
+    UpdateSourceLatency();
+    return ERR_OK;
+}
+
+int32_t DevicestatusManager::UnSubscribeLocked(const DevicestatusDataUtils::DevicestatusType& type,
+    const sptr<IdevicestatusCallback>& callback)
+{
+    if (!IsValidDevicestatusType(type)) {
+        DEV_HILOGE(SERVICE, "invalid type: %{public}d", type);
+        return E_DEVICESTATUS_INVALID_TYPE;
+    }
+    auto recordIter = subscribers_.find(callback->AsObject());
+    if ((recordIter == subscribers_.end()) || (recordIter->second.types.count(type) == 0)) {
+        DEV_HILOGI(SERVICE, "callback is not subscribed to type: %{public}d", type);
+        return E_DEVICESTATUS_NOT_SUBSCRIBED;
+    }
+    RemoveSubscription(type, recordIter->second.subscriber->GetCallback());
+    if (recordIter->second.types.empty()) {
+        RemoveSubscriber(recordIter);
+    }
+    DEV_HILOGI(SERVICE, "%{public}s callbacklist.size=%{public}zu", GetDevicestatusTypeName(type),
+        listenerMap_[type].size());
+    return ERR_OK;
+}
 
-    auto dtTypeIter = listenerMap_.find(type);
-    if (dtTypeIter == listenerMap_.end()) {
+size_t DevicestatusManager::ReapDeadSubscriber(const sptr<IRemoteObject>& object)
+{
+    DEV_HILOGI(SERVICE, "Enter");
+    DEVICESTATUS_RETURN_IF_WITH_RET(object == nullptr, 0);
+    std::lock_guard lock(mutex_);
+    auto recordIter = subscribers_.find(object);
+    if (recordIter == subscribers_.end()) {
+        DEV_HILOGI(SERVICE, "no subscription for dead remote");
+        return 0;
+    }
+    std::set<DevicestatusDataUtils::DevicestatusType> types = recordIter->second.types;
+    sptr<IdevicestatusCallback> callback = recordIter->second.subscriber->GetCallback();
+    for (const auto& type : types) {
+        RemoveSubscription(type, callback);
+    }
+    RemoveSubscriber(recordIter);
+    size_t reaped = types.size();
+    reapedCount_ += reaped;
+    DEV_HILOGI(SERVICE, "reaped %{public}zu dead subscriptions", reaped);
+    return reaped;
+}
+
+void DevicestatusManager::RemoveSubscription(const DevicestatusDataUtils::DevicestatusType& type,
+    const sptr<IdevicestatusCallback>& callback)
+{
+    auto& listeners = listenerMap_[type];
+    // The last subscriber of a type stops the source behind it.
+    if ((listeners.erase(callback) > 0) && listeners.empty()) {
+        DisableRdb(type);
+    }
+    auto recordIter = subscribers_.find(callback->AsObject());
+    if (recordIter != subscribers_.end()) {
+        recordIter->second.types.erase(type);
+    }
+    PublishListenerSnapshot(type);
+    UpdateSourceLatency();
+}
+
+void DevicestatusManager::RemoveSubscriber(std::map<sptr<IRemoteObject>, SubscriptionRecord>::iterator recordIter)
+{
+    recordIter->second.subscriber->Close();
+    DevicestatusSubscriber::Stats stats = recordIter->second.subscriber->GetStats();
+    retiredStats_.delivered += stats.delivered;
+    retiredStats_.coalesced += stats.coalesced;
+    retiredStats_.dropped += stats.dropped;
+    retiredStats_.ringed += stats.ringed;
+    retiredStats_.ringFull += stats.ringFull;
+    recordIter->first->RemoveDeathRecipient(devicestatusCBDeathRecipient_);
+    subscribers_.erase(recordIter);
+}
+
+void DevicestatusManager::UpdateSourceLatency()
+{
+    if (msdpImpl_ == nullptr) {
         return;
-    } else {
-        DEV_HILOGI(SERVICE, "callbacklist.size=%{public}zu",
-            listenerMap_[dtTypeIter->first].size());
-        auto iter = listenerMap_[dtTypeIter->first].find(callback);
-        if (iter != listenerMap_[dtTypeIter->first].end()) {
-            if (listenerMap_[dtTypeIter->first].erase(callback) != 0) {
-                object->RemoveDeathRecipient(devicestatusCBDeathRecipient_);
-                if (listenerMap_[dtTypeIter->first].size() == 0) {
-                    listenerMap_.erase(dtTypeIter);
-                }
-            }
+    }
+    std::array<bool, DevicestatusMsdpClientImpl::SOURCE_MAX> lowLatency {};
+    for (const auto& record : subscribers_) {
+        if (!record.second.subscriber->HasRing()) {
+            continue;
+        }
+        for (const auto& type : record.second.types) {
+            lowLatency[DevicestatusMsdpClientImpl::GetSourceType(type)] = true;
         }
     }
-    DEV_HILOGI(SERVICE, "listenerMap_.size = %{public}zu", listenerMap_.size());
-    if (listenerMap_.empty()) {
-        DisableRdb();
-    } else {
-        DEV_HILOGI(SERVICE, "other subscribe exist");
+    for (size_t source = 0; source < DevicestatusMsdpClientImpl::SOURCE_MAX; ++source) {
+        if (lowLatency[source] == lowLatencySources_[source]) {
+            continue;
+        }
+        // Left unchanged on failure so that the next subscription change tries again.
+        if (msdpImpl_->SetSourceLowLatency(static_cast<DevicestatusMsdpClientImpl::SourceType>(source),
+            lowLatency[source]) == ERR_OK) {
+            lowLatencySources_[source] = lowLatency[source];
+        }
     }
-    DEV_HILOGI(SERVICE, "UnSubscribe success,Exit");
 }
 
 int32_t DevicestatusManager::LoadAlgorithm(bool bCreate)
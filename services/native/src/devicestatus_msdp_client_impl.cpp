@@ -26,6 +26,9 @@
 
 #include "dummy_values_bucket.h"
 #include "devicestatus_common.h"
+#include "devicestatus_filter.h"
+#include "devicestatus_latency_stats.h"
+#include "devicestatus_pipeline.h"
 
 using namespace OHOS::NativeRdb;
 namespace OHOS {
@@ -35,65 +38,148 @@ constexpr int32_t ERR_OK = 0;
 constexpr int32_t ERR_NG = -1;
 const std::string DEVICESTATUS_SENSOR_HDI_LIB_PATH = "libdevicestatus_sensorhdi.z.so";
 const std::string DEVICESTATUS_MSDP_ALGORITHM_LIB_PATH = "libdevicestatus_msdp.z.so";
-std::map<DevicestatusDataUtils::DevicestatusType, DevicestatusDataUtils::DevicestatusValue> g_devicestatusDataMap;
+// Per-type filter settings of the product, read once when the filter starts.
+const std::string DEVICESTATUS_FILTER_CONFIG_PATH = "/system/etc/devicestatus/devicestatus_filter.json";
+// Written by the plugin threads, read lock-free by the binder threads serving GetCache.
+DevicestatusLatestState g_devicestatusDataMap;
 DevicestatusMsdpClientImpl::CallbackManager g_callbacksMgr;
-using clientType = DevicestatusDataUtils::DevicestatusType;
-using clientValue = DevicestatusDataUtils::DevicestatusValue;
+// Sits between the plugins and g_devicestatusDataMap, so the cached state only ever holds settled values.
+// Stopped by the service before the reactor, its destructor does not touch the reactor.
+DevicestatusFilter g_devicestatusFilter;
 DevicestatusMsdpInterface* g_msdpInterface;
 DevicestatusSensorInterface* g_sensorHdiInterface_;
+
+class FilterStage {
+public:
+    bool Process(DevicestatusDataUtils::DevicestatusData& data)
+    {
+        return g_devicestatusFilter.Filter(data);
+    }
+    void Dump(std::string& out) const
+    {
+        g_devicestatusFilter.Dump(out);
+    }
+};
+
+// Assigns the sequence number and publishes the event as the latest state of its type.
+class StateStage {
+public:
+    bool Process(DevicestatusDataUtils::DevicestatusData& data)
+    {
+        data = DevicestatusMsdpClientImpl::SaveObserverData(data);
+        return data.sequence != 0;
+    }
+    void Dump(std::string& out) const {}
+};
+
+// Hands the event to the manager, which fans it out to the subscribers.
+class NotifyStage {
+public:
+    bool Process(DevicestatusDataUtils::DevicestatusData& data)
+    {
+        if (g_callbacksMgr == nullptr) {
+            DEV_HILOGI(SERVICE, "g_callbacksMgr is nullptr");
+            return false;
+        }
+        g_callbacksMgr(data);
+        return true;
+    }
+    void Dump(std::string& out) const {}
+};
+
+using EventPipeline = DevicestatusPipeline<
+    DevicestatusStampStage,
+    FilterStage,
+    StateStage,
+    DevicestatusLatencyStage<DevicestatusLatencyStats::HOP_SOURCE_TO_IMPL>,
+    NotifyStage>;
+// Where events the filter held back continue once they settle.
+constexpr size_t COMMIT_STAGE = EventPipeline::IndexOf<FilterStage>() + 1;
+EventPipeline g_eventPipeline;
 }
 
-ErrCode DevicestatusMsdpClientImpl::InitMsdpImpl()
+DevicestatusMsdpClientImpl::SourceType DevicestatusMsdpClientImpl::GetSourceType(
+    const DevicestatusDataUtils::DevicestatusType& type)
 {
-    DEV_HILOGI(SERVICE, "Enter");
-    if (g_msdpInterface == nullptr) {
-        g_msdpInterface = GetAlgorithmInst();
-        if (g_msdpInterface == nullptr) {
-            DEV_HILOGI(SERVICE, "get msdp module instance failed");
-            return ERR_NG;
-        }
+    if (type == DevicestatusDataUtils::DevicestatusType::TYPE_LID_OPEN) {
+        return SOURCE_SENSOR_HDI;
     }
+    return SOURCE_MSDP_ALGORITHM;
+}
 
-    if (g_sensorHdiInterface_ == nullptr) {
-        g_sensorHdiInterface_ = GetSensorHdiInst();
+ErrCode DevicestatusMsdpClientImpl::EnableSource(SourceType source)
+{
+    DEV_HILOGI(SERVICE, "Enter, source: %{public}d", source);
+    if (source == SOURCE_SENSOR_HDI) {
         if (g_sensorHdiInterface_ == nullptr) {
-            DEV_HILOGI(SERVICE, "get sensor module instance failed");
+            g_sensorHdiInterface_ = GetSensorHdiInst();
+        }
+        if (g_sensorHdiInterface_ == nullptr) {
+            DEV_HILOGE(SERVICE, "get sensor module instance failed");
             return ERR_NG;
         }
+        g_sensorHdiInterface_->Enable();
+        return ERR_OK;
     }
 
+    if (g_msdpInterface == nullptr) {
+        g_msdpInterface = GetAlgorithmInst();
+    }
+    if (g_msdpInterface == nullptr) {
+        DEV_HILOGE(SERVICE, "get msdp module instance failed");
+        return ERR_NG;
+    }
     g_msdpInterface->Enable();
-    g_sensorHdiInterface_->Enable();
-
-    DEV_HILOGI(SERVICE, "Exit");
     return ERR_OK;
 }
 
-ErrCode DevicestatusMsdpClientImpl::DisableMsdpImpl()
+ErrCode DevicestatusMsdpClientImpl::DisableSource(SourceType source)
 {
-    DEV_HILOGI(SERVICE, "Enter");
+    DEV_HILOGI(SERVICE, "Enter, source: %{public}d", source);
+    if (source == SOURCE_SENSOR_HDI) {
+        if (g_sensorHdiInterface_ == nullptr) {
+            DEV_HILOGE(SERVICE, "disable sensor source failed");
+            return ERR_NG;
+        }
+        g_sensorHdiInterface_->Disable();
+        return ERR_OK;
+    }
+
     if (g_msdpInterface == nullptr) {
-        DEV_HILOGI(SERVICE, "disable msdp impl failed");
+        DEV_HILOGE(SERVICE, "disable msdp source failed");
         return ERR_NG;
     }
+    g_msdpInterface->Disable();
+    return ERR_OK;
+}
 
-    if (g_sensorHdiInterface_ == nullptr) {
-        DEV_HILOGI(SERVICE, "disable msdp impl failed");
-        return ERR_NG;
+ErrCode DevicestatusMsdpClientImpl::SetSourceLowLatency(SourceType source, bool lowLatency)
+{
+    DEV_HILOGI(SERVICE, "Enter, source: %{public}d, lowLatency: %{public}d", source, lowLatency);
+    if (source == SOURCE_SENSOR_HDI) {
+        if (g_sensorHdiInterface_ == nullptr) {
+            DEV_HILOGE(SERVICE, "sensor source is not loaded");
+            return ERR_NG;
+        }
+        g_sensorHdiInterface_->SetLowLatency(lowLatency);
+        return ERR_OK;
     }
 
-    g_msdpInterface->Disable();
-    g_sensorHdiInterface_->Disable();
-    DEV_HILOGI(SERVICE, "Exit");
+    if (g_msdpInterface == nullptr) {
+        DEV_HILOGE(SERVICE, "msdp source is not loaded");
+        return ERR_NG;
+    }
+    g_msdpInterface->SetLowLatency(lowLatency);
     return ERR_OK;
 }
 
 ErrCode DevicestatusMsdpClientImpl::RegisterSensor()
 {
     DEV_HILOGI(SERVICE, "Enter");
-    if (g_sensorHdiInterface_ != nullptr) {
+    if ((g_sensorHdiInterface_ != nullptr) && !sensorRegistered_) {
         std::shared_ptr<DevicestatusSensorHdiCallback> callback = std::make_shared<DevicestatusMsdpClientImpl>();
         g_sensorHdiInterface_->RegisterCallback(callback);
+        sensorRegistered_ = true;
         DEV_HILOGI(SERVICE, "g_sensorHdiInterface_ is not nullptr");
     }
 
@@ -112,6 +198,7 @@ ErrCode DevicestatusMsdpClientImpl::UnregisterSensor(void)
 
     g_sensorHdiInterface_->UnregisterCallback();
     g_sensorHdiInterface_ = nullptr;
+    sensorRegistered_ = false;
 
     DEV_HILOGI(SERVICE, "Exit");
     return ERR_OK;
@@ -121,6 +208,11 @@ ErrCode DevicestatusMsdpClientImpl::RegisterImpl(const CallbackManager& callback
 {
     DEV_HILOGI(SERVICE, "Enter");
     g_callbacksMgr = callback;
+    if (!g_devicestatusFilter.Start(&DevicestatusMsdpClientImpl::CommitData)) {
+        DEV_HILOGE(SERVICE, "start filter failed, events are not filtered");
+    } else if (g_devicestatusFilter.LoadConfig(DEVICESTATUS_FILTER_CONFIG_PATH) != ERR_OK) {
+        DEV_HILOGE(SERVICE, "filter config not fully applied");
+    }
 
     if (g_msdpInterface == nullptr) {
         g_msdpInterface = GetAlgorithmInst();
@@ -144,49 +236,33 @@ ErrCode DevicestatusMsdpClientImpl::RegisterImpl(const CallbackManager& callback
     return ERR_OK;
 }
 
-ErrCode DevicestatusMsdpClientImpl::UnregisterImpl()
+void DevicestatusMsdpClientImpl::StopFilter()
 {
     DEV_HILOGI(SERVICE, "Enter");
-    if (g_callbacksMgr == nullptr) {
-        DEV_HILOGI(SERVICE, "unregister callback failed");
-        return ERR_NG;
-    }
-
-    UnregisterMsdp();
-    UnregisterSensor();
-
-    g_callbacksMgr = nullptr;
-
-    return ERR_OK;
-}
-
-ErrCode DevicestatusMsdpClientImpl::ImplCallback(const DevicestatusDataUtils::DevicestatusData& data)
-{
-    if (g_callbacksMgr == nullptr) {
-        DEV_HILOGI(SERVICE, "g_callbacksMgr is nullptr");
-        return ERR_NG;
-    }
-    g_callbacksMgr(data);
-
-    return ERR_OK;
+    g_devicestatusFilter.Stop();
 }
 
 void DevicestatusMsdpClientImpl::OnResult(const DevicestatusDataUtils::DevicestatusData& data)
 {
-    MsdpCallback(data);
+    DevicestatusDataUtils::DevicestatusData result = data;
+    result.sourceId = DevicestatusDataUtils::SOURCE_ID_MSDP_ALGORITHM;
+    MsdpCallback(result);
 }
 
 void DevicestatusMsdpClientImpl::OnSensorHdiResult(const DevicestatusDataUtils::DevicestatusData& data)
 {
-    MsdpCallback(data);
+    DevicestatusDataUtils::DevicestatusData result = data;
+    result.sourceId = DevicestatusDataUtils::SOURCE_ID_SENSOR_HDI;
+    MsdpCallback(result);
 }
 
 ErrCode DevicestatusMsdpClientImpl::RegisterMsdp()
 {
     DEV_HILOGI(SERVICE, "Enter");
-    if (g_msdpInterface != nullptr) {
+    if ((g_msdpInterface != nullptr) && !msdpRegistered_) {
         std::shared_ptr<MsdpAlgorithmCallback> callback = std::make_shared<DevicestatusMsdpClientImpl>();
         g_msdpInterface->RegisterCallback(callback);
+        msdpRegistered_ = true;
     }
 
     DEV_HILOGI(SERVICE, "Exit");
@@ -204,6 +280,7 @@ ErrCode DevicestatusMsdpClientImpl::UnregisterMsdp(void)
 
     g_msdpInterface->UnregisterCallback();
     g_msdpInterface = nullptr;
+    msdpRegistered_ = false;
 
     DEV_HILOGI(SERVICE, "Exit");
     return ERR_OK;
@@ -211,37 +288,38 @@ ErrCode DevicestatusMsdpClientImpl::UnregisterMsdp(void)
 
 int32_t DevicestatusMsdpClientImpl::MsdpCallback(const DevicestatusDataUtils::DevicestatusData& data)
 {
-    SaveObserverData(data);
-    if (notifyManagerFlag_) {
-        ImplCallback(data);
-        notifyManagerFlag_ = false;
-    }
+    DevicestatusDataUtils::DevicestatusData result = data;
+    // Transitions the filter holds back continue later from its thread, keeping their observation time.
+    g_eventPipeline.Process(result);
 
     return ERR_OK;
 }
 
+void DevicestatusMsdpClientImpl::CommitData(const DevicestatusDataUtils::DevicestatusData& data)
+{
+    DevicestatusDataUtils::DevicestatusData result = data;
+    g_eventPipeline.Process<COMMIT_STAGE>(result);
+}
+
 DevicestatusDataUtils::DevicestatusData DevicestatusMsdpClientImpl::SaveObserverData(
     const DevicestatusDataUtils::DevicestatusData& data)
 {
-    DEV_HILOGI(SERVICE, "Enter");
-    for (auto iter = g_devicestatusDataMap.begin(); iter != g_devicestatusDataMap.end(); ++iter) {
-        if (iter->first == data.type) {
-            iter->second = data.value;
-            notifyManagerFlag_ = true;
-            return data;
-        }
+    DevicestatusDataUtils::DevicestatusData result = data;
+    if (result.timestamp == 0) {
+        result.timestamp = DevicestatusGetBootTime();
+    }
+    result.sequence = g_devicestatusDataMap.Update(result.type, result.value, result.timestamp);
+    if (result.sequence == 0) {
+        DEV_HILOGE(SERVICE, "invalid type: %{public}d", data.type);
     }
 
-    g_devicestatusDataMap.insert(std::make_pair(data.type, data.value));
-    notifyManagerFlag_ = true;
-
-    return data;
+    return result;
 }
 
-std::map<clientType, clientValue> DevicestatusMsdpClientImpl::GetObserverData() const
+bool DevicestatusMsdpClientImpl::GetObserverData(const DevicestatusDataUtils::DevicestatusType& type,
+    DevicestatusLatestState::Entry& entry) const
 {
-    DEV_HILOGI(SERVICE, "Enter");
-    return g_devicestatusDataMap;
+    return g_devicestatusDataMap.Read(type, entry);
 }
 
 void DevicestatusMsdpClientImpl::GetDevicestatusTimestamp()
@@ -268,6 +346,7 @@ void DevicestatusMsdpClientImpl::GetLatitude()
 int32_t DevicestatusMsdpClientImpl::LoadSensorHdiLibrary(bool bCreate)
 {
     DEV_HILOGI(SERVICE, "Enter");
+    std::unique_lock<std::mutex> lock(mMutex_);
     if (sensorHdi_.handle != nullptr) {
         return ERR_OK;
     }
@@ -303,6 +382,8 @@ int32_t DevicestatusMsdpClientImpl::LoadSensorHdiLibrary(bool bCreate)
 int32_t DevicestatusMsdpClientImpl::UnloadSensorHdiLibrary(bool bCreate)
 {
     DEV_HILOGI(SERVICE, "Enter");
+    // Dump reads the plugin under mMutex_ and calls into it, so it must not be torn down underneath.
+    std::unique_lock<std::mutex> lock(mMutex_);
     if (sensorHdi_.handle == nullptr) {
         return ERR_NG;
     }
@@ -342,6 +423,7 @@ DevicestatusSensorInterface* DevicestatusMsdpClientImpl::GetSensorHdiInst()
 int32_t DevicestatusMsdpClientImpl::LoadAlgorithmLibrary(bool bCreate)
 {
     DEV_HILOGI(SERVICE, "Enter");
+    std::unique_lock<std::mutex> lock(mMutex_);
     if (mAlgorithm_.handle != nullptr) {
         return ERR_OK;
     }
@@ -376,6 +458,7 @@ int32_t DevicestatusMsdpClientImpl::LoadAlgorithmLibrary(bool bCreate)
 int32_t DevicestatusMsdpClientImpl::UnloadAlgorithmLibrary(bool bCreate)
 {
     DEV_HILOGI(SERVICE, "Enter");
+    std::unique_lock<std::mutex> lock(mMutex_);
     if (mAlgorithm_.handle == nullptr) {
         return ERR_NG;
     }
@@ -394,6 +477,25 @@ int32_t DevicestatusMsdpClientImpl::UnloadAlgorithmLibrary(bool bCreate)
     return ERR_OK;
 }
 
+void DevicestatusMsdpClientImpl::Dump(std::string& out)
+{
+    std::unique_lock<std::mutex> lock(mMutex_);
+    out.append("msdp plugin: ").append((mAlgorithm_.handle != nullptr) ? "loaded" : "not loaded");
+    out.append(", instance: ").append((mAlgorithm_.pAlgorithm != nullptr) ? "created" : "none");
+    out.append(", registered: ").append(msdpRegistered_ ? "yes" : "no");
+    if (mAlgorithm_.pAlgorithm != nullptr) {
+        out.append(", ").append(mAlgorithm_.pAlgorithm->Dump());
+    }
+    out.append("\nsensor plugin: ").append((sensorHdi_.handle != nullptr) ? "loaded" : "not loaded");
+    out.append(", instance: ").append((sensorHdi_.pAlgorithm != nullptr) ? "created" : "none");
+    out.append(", registered: ").append(sensorRegistered_ ? "yes" : "no");
+    if (sensorHdi_.pAlgorithm != nullptr) {
+        out.append(", ").append(sensorHdi_.pAlgorithm->Dump());
+    }
+    out.append("\n");
+    g_eventPipeline.Dump(out);
+}
+
 DevicestatusMsdpInterface* DevicestatusMsdpClientImpl::GetAlgorithmInst()
 {
     DEV_HILOGI(SERVICE, "Enter");
@@ -15,18 +15,27 @@
 
 #include "devicestatus_service.h"
 
+#include <cstdio>
 #include <ipc_skeleton.h>
+#include <unistd.h>
+#include <string_ex.h>
 #include "if_system_ability_manager.h"
 #include "iservice_registry.h"
 #include "system_ability_definition.h"
 #include "devicestatus_permission.h"
 #include "devicestatus_common.h"
+#include "devicestatus_latency_stats.h"
+#include "devicestatus_reactor.h"
 
 namespace OHOS {
 namespace Msdp {
 namespace {
 auto ms = DelayedSpSingleton<DevicestatusService>::GetInstance();
 const bool G_REGISTER_RESULT = SystemAbility::MakeAndRegisterAbility(ms.GetRefPtr());
+const std::string DUMP_USAGE =
+    "usage: hidumper -s 2902 -a \"[option]\"\n"
+    "  -h          show this help\n"
+    "  -r          reset the latency histograms after dumping them\n";
 }
 DevicestatusService::DevicestatusService() : SystemAbility(MSDP_DEVICESTATUS_SERVICE_ID, true)
 {
@@ -67,14 +76,57 @@ void DevicestatusService::OnStop()
         DEV_HILOGI(SERVICE, "devicestatusManager_ is null");
         return;
     }
+    devicestatusManager_->StopFilter();
     devicestatusManager_->UnloadAlgorithm(false);
     DEV_HILOGI(SERVICE, "unload algorithm library exit");
+    // The filter and the plugins have removed their registrations, nothing is left on the reactor.
+    DevicestatusReactor::GetInstance().Stop();
+}
+
+int32_t DevicestatusService::Dump(int32_t fd, const std::vector<std::u16string>& args)
+{
+    DEV_HILOGI(SERVICE, "Enter");
+    if (fd < 0) {
+        DEV_HILOGE(SERVICE, "invalid fd: %{public}d", fd);
+        return ERR_INVALID_VALUE;
+    }
+    bool reset = false;
+    for (size_t i = 0; i < args.size(); ++i) {
+        std::string option = Str16ToStr8(args[i]);
+        if (option == "-h") {
+            dprintf(fd, "%s", DUMP_USAGE.c_str());
+            return ERR_OK;
+        }
+        if (option == "-r") {
+            reset = true;
+            continue;
+        }
+        dprintf(fd, "unknown option: %s\n%s", option.c_str(), DUMP_USAGE.c_str());
+        return ERR_INVALID_VALUE;
+    }
+
+    std::string out;
+    out.append("ready: ").append(ready_ ? "yes" : "no").append("\n");
+    if (devicestatusManager_ != nullptr) {
+        devicestatusManager_->Dump(out);
+    }
+    DevicestatusReactor::GetInstance().Dump(out);
+    out.append("latency:\n").append(DevicestatusLatencyStats::GetInstance().Dump());
+    if (reset) {
+        DevicestatusLatencyStats::GetInstance().Reset();
+    }
+    dprintf(fd, "%s", out.c_str());
+    return ERR_OK;
 }
 
 bool DevicestatusService::Init()
 {
     DEV_HILOGI(SERVICE, "Enter");
 
+    if (!DevicestatusReactor::GetInstance().Start()) {
+        DEV_HILOGE(SERVICE, "OnStart start reactor fail");
+        return false;
+    }
     if (!devicestatusManager_) {
         devicestatusManager_ = std::make_shared<DevicestatusManager>(ms);
     }
@@ -132,5 +184,60 @@ DevicestatusDataUtils::DevicestatusData DevicestatusService::GetCache(const \
     }
     return devicestatusManager_->GetLatestDevicestatusData(type);
 }
+
+int32_t DevicestatusService::SubscribeTypes(uint32_t typeMask, const sptr<IdevicestatusCallback>& callback,
+    DevicestatusTypeTable<int32_t>& results)
+{
+    DEV_HILOGI(SERVICE, "Enter");
+    if (devicestatusManager_ == nullptr) {
+        DEV_HILOGI(SERVICE, "SubscribeTypes func is nullptr");
+        return E_DEVICESTATUS_INNER_ERR;
+    }
+    return devicestatusManager_->SubscribeTypes(typeMask, callback, results);
+}
+
+int32_t DevicestatusService::UnSubscribeTypes(uint32_t typeMask, const sptr<IdevicestatusCallback>& callback,
+    DevicestatusTypeTable<int32_t>& results)
+{
+    DEV_HILOGI(SERVICE, "Enter");
+    if (devicestatusManager_ == nullptr) {
+        DEV_HILOGI(SERVICE, "UnSubscribeTypes func is nullptr");
+        return E_DEVICESTATUS_INNER_ERR;
+    }
+    return devicestatusManager_->UnSubscribeTypes(typeMask, callback, results);
+}
+
+int32_t DevicestatusService::GetSnapshot(uint32_t typeMask,
+    DevicestatusTypeTable<DevicestatusLatestState::Entry>& entries)
+{
+    DEV_HILOGI(SERVICE, "Enter");
+    if (devicestatusManager_ == nullptr) {
+        DEV_HILOGI(SERVICE, "GetSnapshot func is nullptr");
+        return E_DEVICESTATUS_INNER_ERR;
+    }
+    return devicestatusManager_->GetLatestDevicestatusSnapshot(typeMask, entries);
+}
+
+int32_t DevicestatusService::RegisterEventRing(const sptr<IdevicestatusCallback>& callback,
+    const sptr<Ashmem>& memory, int32_t doorbellFd)
+{
+    DEV_HILOGI(SERVICE, "Enter");
+    if (devicestatusManager_ == nullptr) {
+        DEV_HILOGI(SERVICE, "RegisterEventRing func is nullptr");
+        close(doorbellFd);
+        return E_DEVICESTATUS_INNER_ERR;
+    }
+    return devicestatusManager_->AttachEventRing(callback, memory, doorbellFd);
+}
+
+int32_t DevicestatusService::UnregisterEventRing(const sptr<IdevicestatusCallback>& callback)
+{
+    DEV_HILOGI(SERVICE, "Enter");
+    if (devicestatusManager_ == nullptr) {
+        DEV_HILOGI(SERVICE, "UnregisterEventRing func is nullptr");
+        return E_DEVICESTATUS_INNER_ERR;
+    }
+    return devicestatusManager_->DetachEventRing(callback);
+}
 } // namespace Msdp
 } // namespace OHOS
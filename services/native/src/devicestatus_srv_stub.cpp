@@ -45,6 +45,19 @@ int32_t DevicestatusSrvStub::OnRemoteRequest(uint32_t code, MessageParcel &data,
         case static_cast<int32_t>(Idevicestatus::DEVICESTATUS_GETCACHE): {
             return GetLatestDevicestatusDataStub(data, reply);
         }
+        case static_cast<int32_t>(Idevicestatus::DEVICESTATUS_SUBSCRIBE_TYPES):
+        case static_cast<int32_t>(Idevicestatus::DEVICESTATUS_UNSUBSCRIBE_TYPES): {
+            return SubscribeTypesStub(code, data, reply);
+        }
+        case static_cast<int32_t>(Idevicestatus::DEVICESTATUS_GET_SNAPSHOT): {
+            return GetSnapshotStub(data, reply);
+        }
+        case static_cast<int32_t>(Idevicestatus::DEVICESTATUS_REGISTER_EVENT_RING): {
+            return RegisterEventRingStub(data, reply);
+        }
+        case static_cast<int32_t>(Idevicestatus::DEVICESTATUS_UNREGISTER_EVENT_RING): {
+            return UnregisterEventRingStub(data, reply);
+        }
         default: {
             return IPCObjectStub::OnRemoteRequest(code, data, reply, option);
         }
@@ -91,6 +104,105 @@ int32_t DevicestatusSrvStub::GetLatestDevicestatusDataStub(MessageParcel& data,
     DEV_HILOGD(SERVICE, "devicestatusData.value: %{public}d", devicestatusData.value);
     DEVICESTATUS_WRITE_PARCEL_WITH_RET(reply, Int32, devicestatusData.type, E_DEVICESTATUS_WRITE_PARCEL_ERROR);
     DEVICESTATUS_WRITE_PARCEL_WITH_RET(reply, Int32, devicestatusData.value, E_DEVICESTATUS_WRITE_PARCEL_ERROR);
+    // Same extension as the callback parcel, after the value so that older proxies still parse the reply.
+    DEVICESTATUS_WRITE_PARCEL_WITH_RET(reply, Int32, DevicestatusDataUtils::DATA_EXTENSION_VERSION,
+        E_DEVICESTATUS_WRITE_PARCEL_ERROR);
+    DEVICESTATUS_WRITE_PARCEL_WITH_RET(reply, Int64, devicestatusData.timestamp, E_DEVICESTATUS_WRITE_PARCEL_ERROR);
+    DEVICESTATUS_WRITE_PARCEL_WITH_RET(reply, Uint64, devicestatusData.sequence, E_DEVICESTATUS_WRITE_PARCEL_ERROR);
+    DEVICESTATUS_WRITE_PARCEL_WITH_RET(reply, Int32, devicestatusData.sourceId, E_DEVICESTATUS_WRITE_PARCEL_ERROR);
+    DEV_HILOGD(SERVICE, "Exit");
+    return ERR_OK;
+}
+
+int32_t DevicestatusSrvStub::SubscribeTypesStub(uint32_t code, MessageParcel& data, MessageParcel& reply)
+{
+    DEV_HILOGD(SERVICE, "Enter");
+    uint32_t typeMask = 0;
+    DEVICESTATUS_READ_PARCEL_WITH_RET(data, Uint32, typeMask, E_DEVICESTATUS_READ_PARCEL_ERROR);
+    sptr<IRemoteObject> obj = data.ReadRemoteObject();
+    DEVICESTATUS_RETURN_IF_WITH_RET((obj == nullptr), E_DEVICESTATUS_READ_PARCEL_ERROR);
+    sptr<IdevicestatusCallback> callback = iface_cast<IdevicestatusCallback>(obj);
+    DEVICESTATUS_RETURN_IF_WITH_RET((callback == nullptr), E_DEVICESTATUS_READ_PARCEL_ERROR);
+    if ((typeMask & ~DEVICESTATUS_TYPE_MASK_ALL) != 0) {
+        DEV_HILOGE(SERVICE, "ignore unknown types in mask: 0x%{public}x", typeMask);
+        typeMask &= DEVICESTATUS_TYPE_MASK_ALL;
+    }
+
+    DevicestatusTypeTable<int32_t> results(E_DEVICESTATUS_INVALID_TYPE);
+    if (code == Idevicestatus::DEVICESTATUS_SUBSCRIBE_TYPES) {
+        SubscribeTypes(typeMask, callback, results);
+    } else {
+        UnSubscribeTypes(typeMask, callback, results);
+    }
+
+    DEVICESTATUS_WRITE_PARCEL_WITH_RET(reply, Uint32, typeMask, E_DEVICESTATUS_WRITE_PARCEL_ERROR);
+    for (size_t i = 0; i < DEVICESTATUS_TYPE_COUNT; ++i) {
+        DevicestatusDataUtils::DevicestatusType type = DevicestatusTypeTable<int32_t>::TypeAt(i);
+        if ((typeMask & DevicestatusTypeMask(type)) != 0) {
+            DEVICESTATUS_WRITE_PARCEL_WITH_RET(reply, Int32, results[type], E_DEVICESTATUS_WRITE_PARCEL_ERROR);
+        }
+    }
+    DEV_HILOGD(SERVICE, "Exit");
+    return ERR_OK;
+}
+
+int32_t DevicestatusSrvStub::GetSnapshotStub(MessageParcel& data, MessageParcel& reply)
+{
+    DEV_HILOGD(SERVICE, "Enter");
+    uint32_t typeMask = 0;
+    DEVICESTATUS_READ_PARCEL_WITH_RET(data, Uint32, typeMask, E_DEVICESTATUS_READ_PARCEL_ERROR);
+    typeMask &= DEVICESTATUS_TYPE_MASK_ALL;
+
+    DevicestatusTypeTable<DevicestatusLatestState::Entry> entries;
+    int32_t ret = GetSnapshot(typeMask, entries);
+    if (ret != ERR_OK) {
+        DEV_HILOGE(SERVICE, "get snapshot failed, ret: %{public}d", ret);
+        return ret;
+    }
+
+    DEVICESTATUS_WRITE_PARCEL_WITH_RET(reply, Uint32, typeMask, E_DEVICESTATUS_WRITE_PARCEL_ERROR);
+    for (size_t i = 0; i < DEVICESTATUS_TYPE_COUNT; ++i) {
+        DevicestatusDataUtils::DevicestatusType type = DevicestatusTypeTable<int32_t>::TypeAt(i);
+        if ((typeMask & DevicestatusTypeMask(type)) == 0) {
+            continue;
+        }
+        DEVICESTATUS_WRITE_PARCEL_WITH_RET(reply, Int32, entries[type].value, E_DEVICESTATUS_WRITE_PARCEL_ERROR);
+        DEVICESTATUS_WRITE_PARCEL_WITH_RET(reply, Int64, entries[type].timestamp, E_DEVICESTATUS_WRITE_PARCEL_ERROR);
+        DEVICESTATUS_WRITE_PARCEL_WITH_RET(reply, Uint64, entries[type].sequence, E_DEVICESTATUS_WRITE_PARCEL_ERROR);
+    }
+    DEV_HILOGD(SERVICE, "Exit");
+    return ERR_OK;
+}
+
+int32_t DevicestatusSrvStub::RegisterEventRingStub(MessageParcel& data, MessageParcel& reply)
+{
+    DEV_HILOGD(SERVICE, "Enter");
+    sptr<IRemoteObject> obj = data.ReadRemoteObject();
+    DEVICESTATUS_RETURN_IF_WITH_RET((obj == nullptr), E_DEVICESTATUS_READ_PARCEL_ERROR);
+    sptr<IdevicestatusCallback> callback = iface_cast<IdevicestatusCallback>(obj);
+    DEVICESTATUS_RETURN_IF_WITH_RET((callback == nullptr), E_DEVICESTATUS_READ_PARCEL_ERROR);
+    sptr<Ashmem> memory = data.ReadAshmem();
+    DEVICESTATUS_RETURN_IF_WITH_RET((memory == nullptr), E_DEVICESTATUS_READ_PARCEL_ERROR);
+    // The parcel hands over a dup of the client's eventfd, RegisterEventRing owns it from here on.
+    int32_t doorbellFd = data.ReadFileDescriptor();
+    DEVICESTATUS_RETURN_IF_WITH_RET((doorbellFd < 0), E_DEVICESTATUS_READ_PARCEL_ERROR);
+
+    int32_t ret = RegisterEventRing(callback, memory, doorbellFd);
+    DEVICESTATUS_WRITE_PARCEL_WITH_RET(reply, Int32, ret, E_DEVICESTATUS_WRITE_PARCEL_ERROR);
+    DEV_HILOGD(SERVICE, "Exit");
+    return ERR_OK;
+}
+
+int32_t DevicestatusSrvStub::UnregisterEventRingStub(MessageParcel& data, MessageParcel& reply)
+{
+    DEV_HILOGD(SERVICE, "Enter");
+    sptr<IRemoteObject> obj = data.ReadRemoteObject();
+    DEVICESTATUS_RETURN_IF_WITH_RET((obj == nullptr), E_DEVICESTATUS_READ_PARCEL_ERROR);
+    sptr<IdevicestatusCallback> callback = iface_cast<IdevicestatusCallback>(obj);
+    DEVICESTATUS_RETURN_IF_WITH_RET((callback == nullptr), E_DEVICESTATUS_READ_PARCEL_ERROR);
+
+    int32_t ret = UnregisterEventRing(callback);
+    DEVICESTATUS_WRITE_PARCEL_WITH_RET(reply, Int32, ret, E_DEVICESTATUS_WRITE_PARCEL_ERROR);
     DEV_HILOGD(SERVICE, "Exit");
     return ERR_OK;
 }
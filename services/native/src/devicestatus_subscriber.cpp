@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "devicestatus_subscriber.h"
+
+#include <cerrno>
+#include <unistd.h>
+
+#include "devicestatus_common.h"
+#include "devicestatus_latency_stats.h"
+
+namespace OHOS {
+namespace Msdp {
+DevicestatusSubscriber::~DevicestatusSubscriber()
+{
+    ReleaseRingLocked();
+}
+
+bool DevicestatusSubscriber::Push(const DevicestatusDataUtils::DevicestatusData& data)
+{
+    if (!IsValidDevicestatusType(data.type)) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (closed_) {
+        ++dropped_;
+        return false;
+    }
+    values_[data.type] = data;
+    if (queued_[data.type]) {
+        ++coalesced_;
+    } else {
+        queued_[data.type] = true;
+        order_[(head_ + size_) % TYPE_COUNT] = data.type;
+        ++size_;
+    }
+    if (scheduled_) {
+        return false;
+    }
+    scheduled_ = true;
+    return true;
+}
+
+bool DevicestatusSubscriber::Drain()
+{
+    bool ringDoorbell = false;
+    for (size_t budget = TYPE_COUNT; budget > 0; --budget) {
+        DevicestatusDataUtils::DevicestatusData data;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (closed_ || (size_ == 0)) {
+                break;
+            }
+            DevicestatusDataUtils::DevicestatusType type = order_[head_];
+            head_ = (head_ + 1) % TYPE_COUNT;
+            --size_;
+            queued_[type] = false;
+            data = values_[type];
+        }
+        Deliver(data, ringDoorbell);
+    }
+    // One doorbell for the whole burst, and only when the client may have gone to sleep on an empty ring.
+    if (ringDoorbell) {
+        std::lock_guard<std::mutex> lock(ringMutex_);
+        if (ringAttached_) {
+            RingDoorbell();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (closed_ || (size_ == 0)) {
+        scheduled_ = false;
+        return false;
+    }
+    return true;
+}
+
+void DevicestatusSubscriber::Deliver(const DevicestatusDataUtils::DevicestatusData& data, bool& ringDoorbell)
+{
+    DevicestatusLatencyStats& latency = DevicestatusLatencyStats::GetInstance();
+    latency.RecordSince(DevicestatusLatencyStats::HOP_SOURCE_TO_DELIVER, data);
+    {
+        std::lock_guard<std::mutex> lock(ringMutex_);
+        if (ringAttached_) {
+            bool wasEmpty = false;
+            if (ring_.Push(data, wasEmpty)) {
+                ringDoorbell = ringDoorbell || wasEmpty;
+                ringed_.fetch_add(1, std::memory_order_relaxed);
+                delivered_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            // The client is not keeping up with its ring, fall back to binder rather than lose the event.
+            ringFull_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    int64_t start = DevicestatusGetBootTime();
+    callback_->OnDevicestatusChanged(data);
+    latency.Record(DevicestatusLatencyStats::HOP_CALLBACK_TRANSACT, data.type, DevicestatusGetBootTime() - start);
+    delivered_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void DevicestatusSubscriber::RingDoorbell()
+{
+    uint64_t one = 1;
+    if (write(doorbellFd_, &one, sizeof(one)) != static_cast<ssize_t>(sizeof(one))) {
+        DEV_HILOGW(SERVICE, "ring doorbell failed, errno: %{public}d", errno);
+    }
+}
+
+bool DevicestatusSubscriber::AttachRing(const sptr<Ashmem>& memory, int32_t doorbellFd)
+{
+    bool closed = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed = closed_;
+    }
+    std::lock_guard<std::mutex> lock(ringMutex_);
+    if (ringAttached_ || closed || (memory == nullptr) || (doorbellFd < 0)) {
+        DEV_HILOGE(SERVICE, "ring already attached or invalid");
+        if (doorbellFd >= 0) {
+            close(doorbellFd);
+        }
+        return false;
+    }
+    int32_t size = memory->GetAshmemSize();
+    if ((size <= 0) || !memory->MapReadAndWriteAshmem()) {
+        DEV_HILOGE(SERVICE, "map ring failed, size: %{public}d", size);
+        close(doorbellFd);
+        return false;
+    }
+    void* base = const_cast<void*>(memory->ReadFromAshmem(size, 0));
+    if (!ring_.Attach(base, static_cast<size_t>(size))) {
+        DEV_HILOGE(SERVICE, "invalid ring layout, size: %{public}d", size);
+        memory->UnmapAshmem();
+        close(doorbellFd);
+        return false;
+    }
+    ringMemory_ = memory;
+    doorbellFd_ = doorbellFd;
+    ringAttached_ = true;
+    return true;
+}
+
+bool DevicestatusSubscriber::DetachRing()
+{
+    std::lock_guard<std::mutex> lock(ringMutex_);
+    if (!ringAttached_) {
+        return false;
+    }
+    ReleaseRingLocked();
+    return true;
+}
+
+bool DevicestatusSubscriber::HasRing() const
+{
+    std::lock_guard<std::mutex> lock(ringMutex_);
+    return ringAttached_;
+}
+
+void DevicestatusSubscriber::ReleaseRingLocked()
+{
+    ringAttached_ = false;
+    ring_ = DevicestatusEventRing();
+    if (ringMemory_ != nullptr) {
+        ringMemory_->UnmapAshmem();
+        ringMemory_->CloseAshmem();
+        ringMemory_ = nullptr;
+    }
+    if (doorbellFd_ >= 0) {
+        close(doorbellFd_);
+        doorbellFd_ = -1;
+    }
+}
+
+void DevicestatusSubscriber::Close()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    dropped_ += size_;
+    queued_.Fill(false);
+    head_ = 0;
+    size_ = 0;
+}
+
+DevicestatusSubscriber::Stats DevicestatusSubscriber::GetStats() const
+{
+    Stats stats;
+    stats.delivered = delivered_.load(std::memory_order_relaxed);
+    stats.ringed = ringed_.load(std::memory_order_relaxed);
+    stats.ringFull = ringFull_.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats.coalesced = coalesced_;
+    stats.dropped = dropped_;
+    stats.pending = size_;
+    return stats;
+}
+} // namespace Msdp
+} // namespace OHOS
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DEVICESTATUS_MANAGER_TEST_H
+#define DEVICESTATUS_MANAGER_TEST_H
+
+#include <atomic>
+#include <gtest/gtest.h>
+
+#include "devicestatus_callback_stub.h"
+#include "devicestatus_manager.h"
+
+namespace OHOS {
+namespace Msdp {
+class DevicestatusManagerTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+
+    class DevicestatusManagerTestCallback : public DevicestatusCallbackStub {
+    public:
+        DevicestatusManagerTestCallback() {};
+        virtual ~DevicestatusManagerTestCallback() {};
+        virtual void OnDevicestatusChanged(const DevicestatusDataUtils::DevicestatusData& devicestatusData) override;
+        static std::atomic<uint64_t> count_;
+    };
+};
+} // namespace Msdp
+} // namespace OHOS
+#endif // DEVICESTATUS_MANAGER_TEST_H
@@ -131,4 +131,27 @@ HWTEST_F (DevicestatusAgentTest, DevicestatusAgentTest003, TestSize.Level1)
     agent2_->UnSubscribeAgentEvent(DevicestatusDataUtils::DevicestatusType::TYPE_LID_OPEN);
     GTEST_LOG_(INFO) << "DevicestatusAgentTest003 end";
 }
+
+/**
+ * @tc.name: DevicestatusAgentTest004
+ * @tc.desc: test one agent routing a type to two handlers and removing them one by one
+ * @tc.type: FUNC
+ */
+HWTEST_F (DevicestatusAgentTest, DevicestatusAgentTest004, TestSize.Level1)
+{
+    GTEST_LOG_(INFO) << "DevicestatusAgentTest004 start";
+    std::shared_ptr<DevicestatusAgentListenerMockFirstClient> agentEvent1 =
+        std::make_shared<DevicestatusAgentListenerMockFirstClient>();
+    std::shared_ptr<DevicestatusAgentListenerMockSecondClient> agentEvent2 =
+        std::make_shared<DevicestatusAgentListenerMockSecondClient>();
+    DevicestatusDataUtils::DevicestatusType type = DevicestatusDataUtils::DevicestatusType::TYPE_LID_OPEN;
+    EXPECT_EQ(ERR_INVALID_VALUE, agent1_->SubscribeAgentEvent(type, nullptr));
+    EXPECT_EQ(ERR_OK, agent1_->SubscribeAgentEvent(type, agentEvent1));
+    EXPECT_EQ(ERR_OK, agent1_->SubscribeAgentEvent(type, agentEvent2));
+    EXPECT_EQ(ERR_OK, agent1_->SubscribeAgentEvent(type, agentEvent2));
+    EXPECT_EQ(ERR_OK, agent1_->UnSubscribeAgentEvent(type, agentEvent1));
+    EXPECT_EQ(E_DEVICESTATUS_NOT_SUBSCRIBED, agent1_->UnSubscribeAgentEvent(type, agentEvent1));
+    EXPECT_EQ(ERR_OK, agent1_->UnSubscribeAgentEvent(type, agentEvent2));
+    GTEST_LOG_(INFO) << "DevicestatusAgentTest004 end";
+}
 }
\ No newline at end of file
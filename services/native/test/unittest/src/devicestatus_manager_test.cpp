@@ -0,0 +1,1113 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "devicestatus_manager_test.h"
+
+#include <algorithm>
+#include <chrono>
+#include <dirent.h>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <poll.h>
+#include <sys/stat.h>
+#include <sys/eventfd.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "devicestatus_backoff.h"
+#include "devicestatus_common.h"
+#include "devicestatus_dispatcher.h"
+#include "devicestatus_event_ring.h"
+#include "devicestatus_filter.h"
+#include "devicestatus_latency_stats.h"
+#include "devicestatus_latest_state.h"
+#include "devicestatus_msdp_rdb.h"
+#include "devicestatus_pipeline.h"
+#include "devicestatus_poll_interval.h"
+#include "devicestatus_rdb_cursor.h"
+#include "devicestatus_reactor.h"
+#include "devicestatus_service.h"
+#include "rdb_helper.h"
+#include "rdb_open_callback.h"
+#include "rdb_store_config.h"
+
+using namespace testing::ext;
+using namespace OHOS::Msdp;
+using namespace OHOS;
+using namespace std;
+
+namespace {
+constexpr uint64_t NOTIFY_BUDGET = 1000000;
+constexpr int32_t DRAIN_WAIT_ROUNDS = 50;
+constexpr int32_t DRAIN_WAIT_MS = 100;
+constexpr int32_t SUBSCRIBE_CYCLES = 1000;
+constexpr int64_t LATEST_STATE_UPDATES = 100000;
+constexpr int32_t LATEST_STATE_READERS = 4;
+const std::string CURSOR_TEST_DATABASE = "/data/test/devicestatus_rdb_cursor_test.db";
+const std::string MSDP_RDB_TEST_DIR = "/data/test/devicestatus_msdp_rdb_test";
+const std::string MSDP_RDB_TEST_DATABASE = MSDP_RDB_TEST_DIR + "/MsdpStub.db";
+const std::string FILTER_TEST_CONFIG = "/data/test/devicestatus_filter_test.json";
+static std::shared_ptr<DevicestatusManager> g_manager;
+}
+
+std::atomic<uint64_t> DevicestatusManagerTest::DevicestatusManagerTestCallback::count_ {0};
+
+void DevicestatusManagerTest::DevicestatusManagerTestCallback::OnDevicestatusChanged(const \
+    DevicestatusDataUtils::DevicestatusData& devicestatusData)
+{
+    count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void DevicestatusManagerTest::SetUpTestCase()
+{
+    g_manager = std::make_shared<DevicestatusManager>(DelayedSpSingleton<DevicestatusService>::GetInstance());
+    g_manager->Init();
+}
+
+void DevicestatusManagerTest::TearDownTestCase()
+{
+    g_manager->StopFilter();
+    g_manager = nullptr;
+}
+
+void DevicestatusManagerTest::SetUp()
+{
+    DevicestatusManagerTestCallback::count_ = 0;
+}
+
+void DevicestatusManagerTest::TearDown()
+{
+}
+
+namespace {
+size_t CountDirEntries(const char* path)
+{
+    DIR* dir = opendir(path);
+    if (dir == nullptr) {
+        return 0;
+    }
+    size_t count = 0;
+    while (readdir(dir) != nullptr) {
+        ++count;
+    }
+    closedir(dir);
+    return count;
+}
+
+void RunNotifyBenchmark(size_t listenerCount)
+{
+    DevicestatusDataUtils::DevicestatusType type = DevicestatusDataUtils::DevicestatusType::TYPE_LID_OPEN;
+    std::vector<sptr<IdevicestatusCallback>> callbacks;
+    for (size_t i = 0; i < listenerCount; ++i) {
+        sptr<IdevicestatusCallback> cb = new DevicestatusManagerTest::DevicestatusManagerTestCallback();
+        g_manager->Subscribe(type, cb);
+        callbacks.push_back(cb);
+    }
+
+    // Keep the total number of callback invocations roughly constant across listener counts.
+    uint64_t iterations = NOTIFY_BUDGET / listenerCount;
+    DevicestatusDataUtils::DevicestatusData data = {type, DevicestatusDataUtils::DevicestatusValue::VALUE_ENTER};
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < iterations; ++i) {
+        g_manager->NotifyDevicestatusChange(data);
+    }
+    auto cost = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    GTEST_LOG_(INFO) << "listeners: " << listenerCount << ", producer: " << (cost.count() / iterations) << " ns/event";
+
+    // Delivery is asynchronous and coalesces per type in each subscriber, so wait for the workers to go idle.
+    uint64_t expected = iterations * listenerCount;
+    uint64_t delivered = 0;
+    for (int32_t i = 0; i < DRAIN_WAIT_ROUNDS; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(DRAIN_WAIT_MS));
+        uint64_t current = DevicestatusManagerTest::DevicestatusManagerTestCallback::count_.load();
+        if ((current == expected) || (current == delivered)) {
+            delivered = current;
+            break;
+        }
+        delivered = current;
+    }
+    GTEST_LOG_(INFO) << "listeners: " << listenerCount << ", delivered: " << delivered << "/" << expected;
+    EXPECT_GT(delivered, 0u);
+
+    for (auto& cb : callbacks) {
+        g_manager->UnSubscribe(type, cb);
+    }
+}
+
+class RecordingCallback : public DevicestatusCallbackStub {
+public:
+    void OnDevicestatusChanged(const DevicestatusDataUtils::DevicestatusData& data) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        events_.push_back(data);
+    }
+    std::vector<DevicestatusDataUtils::DevicestatusData> GetEvents()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return events_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<DevicestatusDataUtils::DevicestatusData> events_;
+};
+
+DevicestatusDataUtils::DevicestatusData MakeEvent(DevicestatusDataUtils::DevicestatusType type,
+    DevicestatusDataUtils::DevicestatusValue value, uint64_t sequence)
+{
+    DevicestatusDataUtils::DevicestatusData data = {type, value};
+    data.sequence = sequence;
+    return data;
+}
+
+// Plays the writer: creates the table the plugins read from.
+class CursorTestOpenCallback : public NativeRdb::RdbOpenCallback {
+public:
+    int32_t OnCreate(NativeRdb::RdbStore& store) override
+    {
+        return store.ExecuteSql("CREATE TABLE IF NOT EXISTS DEVICESTATUSSENSOR "
+            "(ID INTEGER PRIMARY KEY AUTOINCREMENT, DEVICESTATUS_TYPE INTEGER, DEVICESTATUS_STATUS INTEGER)");
+    }
+    int32_t OnUpgrade(NativeRdb::RdbStore& store, int32_t oldVersion, int32_t newVersion) override
+    {
+        return ERR_OK;
+    }
+};
+
+std::shared_ptr<NativeRdb::RdbStore> CreateWriterStore(const std::string& path)
+{
+    NativeRdb::RdbHelper::DeleteRdbStore(path);
+    NativeRdb::RdbStoreConfig config(path);
+    CursorTestOpenCallback callback;
+    int32_t errCode = ERR_OK;
+    return NativeRdb::RdbHelper::GetRdbStore(config, 1, callback, errCode);
+}
+
+void InsertRow(NativeRdb::RdbStore& store, const std::string& type, int32_t status)
+{
+    ASSERT_EQ(store.ExecuteSql("INSERT INTO DEVICESTATUSSENSOR (DEVICESTATUS_TYPE, DEVICESTATUS_STATUS) VALUES (" +
+        type + ", " + std::to_string(status) + ")"), ERR_OK);
+}
+
+class RecordingAlgorithmCallback : public DevicestatusMsdpInterface::MsdpAlgorithmCallback {
+public:
+    void OnResult(const DevicestatusDataUtils::DevicestatusData& data) override
+    {
+        OnResultBatch({ data });
+    }
+    void OnResultBatch(const std::vector<DevicestatusDataUtils::DevicestatusData>& batch) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        batches_.push_back(batch);
+    }
+    std::vector<std::vector<DevicestatusDataUtils::DevicestatusData>> GetBatches()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return batches_;
+    }
+    size_t GetResultCount()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t count = 0;
+        for (const auto& batch : batches_) {
+            count += batch.size();
+        }
+        return count;
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<std::vector<DevicestatusDataUtils::DevicestatusData>> batches_;
+};
+
+bool WaitUntil(const std::function<bool()>& condition)
+{
+    for (int32_t i = 0; i < DRAIN_WAIT_ROUNDS; ++i) {
+        if (condition()) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(DRAIN_WAIT_MS));
+    }
+    return condition();
+}
+}
+
+/**
+ * @tc.name: NotifyBenchmarkTest001
+ * @tc.desc: measure notify cost with 1 listener per type
+ * @tc.type: PERF
+ */
+HWTEST_F (DevicestatusManagerTest, NotifyBenchmarkTest001, TestSize.Level1)
+{
+    RunNotifyBenchmark(1);
+}
+
+/**
+ * @tc.name: NotifyBenchmarkTest002
+ * @tc.desc: measure notify cost with 100 listeners per type
+ * @tc.type: PERF
+ */
+HWTEST_F (DevicestatusManagerTest, NotifyBenchmarkTest002, TestSize.Level1)
+{
+    RunNotifyBenchmark(100);
+}
+
+/**
+ * @tc.name: NotifyBenchmarkTest003
+ * @tc.desc: measure notify cost with 10000 listeners per type
+ * @tc.type: PERF
+ */
+HWTEST_F (DevicestatusManagerTest, NotifyBenchmarkTest003, TestSize.Level1)
+{
+    RunNotifyBenchmark(10000);
+}
+
+/**
+ * @tc.name: SubscribeCycleTest001
+ * @tc.desc: repeated subscribe/unsubscribe must not grow the thread or fd count of the process
+ * @tc.type: FUNC
+ */
+HWTEST_F (DevicestatusManagerTest, SubscribeCycleTest001, TestSize.Level1)
+{
+    sptr<IdevicestatusCallback> cb = new DevicestatusManagerTestCallback();
+    const DevicestatusDataUtils::DevicestatusType types[] = {
+        DevicestatusDataUtils::DevicestatusType::TYPE_HIGH_STILL,
+        DevicestatusDataUtils::DevicestatusType::TYPE_LID_OPEN
+    };
+    // The first cycle lets each backend create its epoll fd, timerfd and looping thread once.
+    for (const auto& type : types) {
+        g_manager->Subscribe(type, cb);
+        g_manager->UnSubscribe(type, cb);
+    }
+    size_t threads = CountDirEntries("/proc/self/task");
+    size_t fds = CountDirEntries("/proc/self/fd");
+    for (int32_t i = 0; i < SUBSCRIBE_CYCLES; ++i) {
+        for (const auto& type : types) {
+            g_manager->Subscribe(type, cb);
+        }
+        for (const auto& type : types) {
+            g_manager->UnSubscribe(type, cb);
+        }
+    }
+    EXPECT_EQ(threads, CountDirEntries("/proc/self/task"));
+    EXPECT_EQ(fds, CountDirEntries("/proc/self/fd"));
+}
+
+/**
+ * @tc.name: LatestStateTest001
+ * @tc.desc: concurrent readers of the latest state table never observe a torn entry
+ * @tc.type: FUNC
+ */
+HWTEST_F (DevicestatusManagerTest, LatestStateTest001, TestSize.Level1)
+{
+    DevicestatusLatestState state;
+    DevicestatusDataUtils::DevicestatusType type = DevicestatusDataUtils::DevicestatusType::TYPE_FINE_STILL;
+    // Each update writes a value that can be derived from its timestamp.
+    auto valueOf = [](int64_t timestamp) {
+        return ((timestamp & 1) != 0) ? DevicestatusDataUtils::DevicestatusValue::VALUE_ENTER :
+            DevicestatusDataUtils::DevicestatusValue::VALUE_EXIT;
+    };
+    std::atomic<bool> stop {false};
+    std::atomic<uint64_t> torn {0};
+    std::vector<std::thread> readers;
+    for (int32_t i = 0; i < LATEST_STATE_READERS; ++i) {
+        readers.emplace_back([&]() {
+            DevicestatusLatestState::Entry entry;
+            while (!stop.load()) {
+                if (state.Read(type, entry) && (entry.sequence != 0) && (entry.value != valueOf(entry.timestamp))) {
+                    torn.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (int64_t timestamp = 1; timestamp <= LATEST_STATE_UPDATES; ++timestamp) {
+        state.Update(type, valueOf(timestamp), timestamp);
+    }
+    stop = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    DevicestatusLatestState::Entry entry;
+    EXPECT_TRUE(state.Read(type, entry));
+    EXPECT_EQ(entry.sequence, static_cast<uint64_t>(LATEST_STATE_UPDATES));
+    EXPECT_EQ(entry.timestamp, LATEST_STATE_UPDATES);
+    EXPECT_EQ(torn.load(), 0u);
+    EXPECT_FALSE(state.Read(DevicestatusDataUtils::DevicestatusType::TYPE_INVALID, entry));
+}
+
+/**
+ * @tc.name: LatencyHistogramTest001
+ * @tc.desc: histogram percentiles stay within one sub-bucket of the recorded values
+ * @tc.type: FUNC
+ */
+HWTEST_F (DevicestatusManagerTest, LatencyHistogramTest001, TestSize.Level1)
+{
+    DevicestatusLatencyHistogram histogram;
+    EXPECT_EQ(histogram.GetPercentile(0.5), 0u);
+    constexpr int64_t samples = 1000;
+    for (int64_t ns = 1; ns <= samples; ++ns) {
+        histogram.Record(ns * 1000);
+    }
+    EXPECT_EQ(histogram.GetCount(), static_cast<uint64_t>(samples));
+    EXPECT_EQ(histogram.GetMax(), static_cast<uint64_t>(samples * 1000));
+    uint64_t p50 = histogram.GetPercentile(0.5);
+    EXPECT_GE(p50, 500000u);
+    EXPECT_LE(p50, 500000u + 500000u / DevicestatusLatencyHistogram::SUB_BUCKET_COUNT);
+    EXPECT_EQ(histogram.GetPercentile(1.0), histogram.GetMax());
+    histogram.Reset();
+    EXPECT_EQ(histogram.GetCount(), 0u);
+}
+
+/**
+ * @tc.name: DumpTest001
+ * @tc.desc: dump reports the subscribers and events of each type
+ * @tc.type: FUNC
+ */
+HWTEST_F (DevicestatusManagerTest, DumpTest001, TestSize.Level1)
+{
+    DevicestatusDataUtils::DevicestatusType type = DevicestatusDataUtils::DevicestatusType::TYPE_CAR_BLUETOOTH;
+    sptr<IdevicestatusCallback> cb = new DevicestatusManagerTestCallback();
+    g_manager->Subscribe(type, cb);
+    DevicestatusDataUtils::DevicestatusData data = {type, DevicestatusDataUtils::DevicestatusValue::VALUE_ENTER};
+    g_manager->NotifyDevicestatusChange(data);
+    std::string out;
+    g_manager->Dump(out);
+    GTEST_LOG_(INFO) << out;
+    EXPECT_NE(out.find("CAR_BLUETOOTH  subscribers=1"), std::string::npos);
+    EXPECT_NE(out.find("dispatcher:"), std::string::npos);
+    g_manager->UnSubscribe(type, cb);
+}
+
+/**
+ * @tc.name: EventRingTest001
+ * @tc.desc: event ring keeps order, reports full and empty transitions and rejects a corrupt header
+ * @tc.type: FUNC
+ */
+HWTEST_F (DevicestatusManagerTest, EventRingTest001, TestSize.Level1)
+{
+    constexpr uint32_t capacity = DevicestatusEventRing::MIN_CAPACITY;
+    std::vector<uint64_t> memory((DevicestatusEventRing::GetSize(capacity) + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+    size_t size = memory.size() * sizeof(uint64_t);
+    DevicestatusEventRing consumer;
+    DevicestatusEventRing producer;
+    ASSERT_TRUE(consumer.Create(memory.data(), size, capacity));
+    ASSERT_TRUE(producer.Attach(memory.data(), size));
+    EXPECT_FALSE(DevicestatusEventRing().Attach(memory.data(), size - 1));
+
+    DevicestatusDataUtils::DevicestatusData data = {DevicestatusDataUtils::DevicestatusType::TYPE_LID_OPEN,
+        DevicestatusDataUtils::DevicestatusValue::VALUE_ENTER};
+    bool wasEmpty = false;
+    for (uint32_t i = 0; i < capacity; ++i) {
+        data.sequence = i;
+        ASSERT_TRUE(producer.Push(data, wasEmpty));
+        EXPECT_EQ(wasEmpty, i == 0);
+    }
+    EXPECT_FALSE(producer.Push(data, wasEmpty));
+
+    DevicestatusDataUtils::DevicestatusData out;
+    for (uint32_t i = 0; i < capacity; ++i) {
+        ASSERT_TRUE(consumer.Pop(out));
+        EXPECT_EQ(out.sequence, i);
+        EXPECT_EQ(out.type, data.type);
+    }
+    EXPECT_FALSE(consumer.Pop(out));
+    EXPECT_TRUE(producer.Push(data, wasEmpty));
+    EXPECT_TRUE(wasEmpty);
+}
+
+/**
+ * @tc.name: EventRingTest002
+ * @tc.desc: a consumer that only sleeps on the doorbell after draining the ring never misses an event
+ * @tc.type: FUNC
+ */
+HWTEST_F (DevicestatusManagerTest, EventRingTest002, TestSize.Level1)
+{
+    constexpr uint32_t capacity = DevicestatusEventRing::MIN_CAPACITY;
+    constexpr uint64_t eventCount = 200000;
+    constexpr int32_t doorbellTimeoutMs = 1000;
+    std::vector<uint64_t> memory((DevicestatusEventRing::GetSize(capacity) + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+    size_t size = memory.size() * sizeof(uint64_t);
+    DevicestatusEventRing consumer;
+    DevicestatusEventRing producer;
+    ASSERT_TRUE(consumer.Create(memory.data(), size, capacity));
+    ASSERT_TRUE(producer.Attach(memory.data(), size));
+    int32_t doorbellFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    ASSERT_GE(doorbellFd, 0);
+
+    std::atomic<bool> stop {false};
+    std::thread producerThread([&producer, &stop, doorbellFd] {
+        DevicestatusDataUtils::DevicestatusData data = {DevicestatusDataUtils::DevicestatusType::TYPE_LID_OPEN,
+            DevicestatusDataUtils::DevicestatusValue::VALUE_ENTER};
+        uint64_t one = 1;
+        for (uint64_t sequence = 1; (sequence <= eventCount) && !stop.load(); ) {
+            data.sequence = sequence;
+            bool wasEmpty = false;
+            if (!producer.Push(data, wasEmpty)) {
+                std::this_thread::yield();
+                continue;
+            }
+            if (wasEmpty) {
+                (void)write(doorbellFd, &one, sizeof(one));
+            }
+            ++sequence;
+        }
+    });
+
+    // Same protocol as DevicestatusRingReader: drain, then sleep on the doorbell.
+    uint64_t expected = 1;
+    bool missed = false;
+    struct pollfd fds = { doorbellFd, POLLIN, 0 };
+    while (expected <= eventCount) {
+        DevicestatusDataUtils::DevicestatusData out;
+        while (consumer.Pop(out)) {
+            EXPECT_EQ(out.sequence, expected);
+            expected = out.sequence + 1;
+        }
+        if (expected > eventCount) {
+            break;
+        }
+        if (poll(&fds, 1, doorbellTimeoutMs) <= 0) {
+            missed = true;
+            break;
+        }
+        uint64_t count = 0;
+        (void)read(doorbellFd, &count, sizeof(count));
+    }
+    stop.store(true);
+    producerThread.join();
+    close(doorbellFd);
+    EXPECT_FALSE(missed);
+    EXPECT_EQ(expected, eventCount + 1);
+}
+
+/**
+ * @tc.name: FilterTest001
+ * @tc.desc: filter suppresses a flap shorter than the dwell time and commits a transition that settles
+ * @tc.type: FUNC
+ */
+HWTEST_F (DevicestatusManagerTest, FilterTest001, TestSize.Level1)
+{
+    std::mutex mutex;
+    std::vector<DevicestatusDataUtils::DevicestatusData> commits;
+    DevicestatusFilter filter;
+    ASSERT_TRUE(filter.Start([&mutex, &commits](const DevicestatusDataUtils::DevicestatusData& data) {
+        std::lock_guard<std::mutex> lock(mutex);
+        commits.push_back(data);
+    }));
+    DevicestatusDataUtils::DevicestatusType type = DevicestatusDataUtils::DevicestatusType::TYPE_LID_OPEN;
+    DevicestatusDataUtils::DevicestatusData enter = {type, DevicestatusDataUtils::DevicestatusValue::VALUE_ENTER};
+    DevicestatusDataUtils::DevicestatusData exit = {type, DevicestatusDataUtils::DevicestatusValue::VALUE_EXIT};
+    EXPECT_TRUE(filter.Filter(enter));
+
+    DevicestatusFilter::Config config;
+    config.enterDwellMs = 50;
+    config.exitDwellMs = 100;
+    ASSERT_EQ(ERR_OK, filter.SetConfig(type, config));
+    EXPECT_FALSE(filter.Filter(exit));
+    EXPECT_FALSE(filter.Filter(enter));
+    EXPECT_FALSE(filter.Filter(exit));
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    filter.Stop();
+
+    ASSERT_EQ(commits.size(), 1u);
+    EXPECT_EQ(commits[0].value, DevicestatusDataUtils::DevicestatusValue::VALUE_EXIT);
+    DevicestatusFilter::Stats stats = filter.GetStats(type);
+    EXPECT_EQ(stats.passed, 2u);
+    EXPECT_EQ(stats.suppressed, 1u);
+    EXPECT_EQ(stats.delayed, 1u);
+}
+
+/**
+ * @tc.name: FilterTest002
+ * @tc.desc: a type set back to pass-through keeps filtering what is pending, then passes events straight through
+ * @tc.type: FUNC
+ */
+HWTEST_F (DevicestatusManagerTest, FilterTest002, TestSize.Level1)
+{
+    DevicestatusFilter filter;
+    ASSERT_TRUE(filter.Start([](const DevicestatusDataUtils::DevicestatusData& data) {}));
+    DevicestatusDataUtils::DevicestatusType type = DevicestatusDataUtils::DevicestatusType::TYPE_HIGH_STILL;
+    DevicestatusDataUtils::DevicestatusData enter = {type, DevicestatusDataUtils::DevicestatusValue::VALUE_ENTER};
+    DevicestatusDataUtils::DevicestatusData exit = {type, DevicestatusDataUtils::DevicestatusValue::VALUE_EXIT};
+    EXPECT_TRUE(filter.Filter(enter));
+
+    DevicestatusFilter::Config config;
+    config.exitDwellMs = DevicestatusFilter::MAX_DWELL_MS;
+    ASSERT_EQ(ERR_OK, filter.SetConfig(type, config));
+    EXPECT_FALSE(filter.Filter(exit));
+    ASSERT_EQ(ERR_OK, filter.SetConfig(type, DevicestatusFilter::Config {}));
+    // The pending exit is still compared against: reverting to the committed value suppresses it.
+    EXPECT_FALSE(filter.Filter(enter));
+    EXPECT_TRUE(filter.Filter(exit));
+    EXPECT_TRUE(filter.Filter(enter));
+    EXPECT_TRUE(filter.Filter(enter));
+    filter.Stop();
+
+    DevicestatusFilter::Stats stats = filter.GetStats(type);
+    EXPECT_EQ(stats.passed, 4u);
+    EXPECT_EQ(stats.suppressed, 1u);
+    EXPECT_EQ(stats.delayed, 0u);
+}
+
+/**
+ * @tc.name: FilterTest003
+ * @tc.desc: filter config file sets the types it names, skips invalid entries and is optional
+ * @tc.type: FUNC
+ */
+HWTEST_F (DevicestatusManagerTest, FilterTest003, TestSize.Level1)
+{
+    using Type = DevicestatusDataUtils::DevicestatusType;
+    DevicestatusFilter filter;
+    EXPECT_EQ(ERR_OK, filter.LoadConfig(FILTER_TEST_CONFIG + ".missing"));
+    {
+        std::ofstream file(FILTER_TEST_CONFIG, std::ios::trunc);
+        file << R"({ "filters": [
+            { "type": "LID_OPEN", "enterDwellMs": 50, "exitDwellMs": 100, "maxPerSecond": 5 },
+            { "type": 1, "maxPerSecond": 2 },
+            { "type": "NO_SUCH_TYPE", "enterDwellMs": 10 },
+            { "type": "HIGH_STILL", "enterDwellMs": -1 }
+        ] })";
+    }
+    EXPECT_NE(ERR_OK, filter.LoadConfig(FILTER_TEST_CONFIG));
+    unlink(FILTER_TEST_CONFIG.c_str());
+
+    DevicestatusFilter::Config config = filter.GetConfig(Type::TYPE_LID_OPEN);
+    EXPECT_EQ(config.enterDwellMs, 50u);
+    EXPECT_EQ(config.exitDwellMs, 100u);
+    EXPECT_EQ(config.maxPerSecond, 5u);
+    config = filter.GetConfig(Type::TYPE_FINE_STILL);
+    EXPECT_EQ(config.enterDwellMs, 0u);
+    EXPECT_EQ(config.maxPerSecond, 2u);
+    EXPECT_TRUE(filter.GetConfig(Type::TYPE_HIGH_STILL).IsPassThrough());
+}
+
+namespace {
+class CountStage {
+public:
+    bool Process(DevicestatusDataUtils::DevicestatusData& data)
+    {
+        data.sequence++;
+        return true;
+    }
+    void Dump(std::string& out) const
+    {
+        out.append("count ");
+    }
+};
+
+class EnterOnlyStage {
+public:
+    bool Process(DevicestatusDataUtils::DevicestatusData& data)
+    {
+        return data.value == DevicestatusDataUtils::DevicestatusValue::VALUE_ENTER;
+    }
+    void Dump(std::string& out) const
+    {
+        out.append("enter ");
+    }
+};
+}
+
+/**
+ * @tc.name: PipelineTest001
+ * @tc.desc: pipeline runs stages in order, stops at the first stage that declines and resumes after it
+ * @tc.type: FUNC
+ */
+HWTEST_F (DevicestatusManagerTest, PipelineTest001, TestSize.Level1)
+{
+    using Pipeline = DevicestatusPipeline<DevicestatusStampStage, CountStage, EnterOnlyStage, CountStage>;
+    static_assert(Pipeline::IndexOf<EnterOnlyStage>() == 2, "stage index");
+    Pipeline pipeline;
+    DevicestatusDataUtils::DevicestatusData data = {DevicestatusDataUtils::DevicestatusType::TYPE_LID_OPEN,
+        DevicestatusDataUtils::DevicestatusValue::VALUE_EXIT};
+    EXPECT_FALSE(pipeline.Process(data));
+    EXPECT_GT(data.timestamp, 0);
+    EXPECT_EQ(data.sequence, 1u);
+    EXPECT_TRUE(pipeline.Process<Pipeline::IndexOf<EnterOnlyStage>() + 1>(data));
+    EXPECT_EQ(data.sequence, 2u);
+    data.value = DevicestatusDataUtils::DevicestatusValue::VALUE_ENTER;
+    EXPECT_TRUE(pipeline.Process(data));
+    EXPECT_EQ(data.sequence, 4u);
+    std::string out;
+    pipeline.Dump(out);
+    EXPECT_EQ(out, "count enter count ");
+}
+
+/**
+ * @tc.name: ReactorTest001
+ * @tc.desc: deferred and periodic timers run on the reactor thread and not after they are removed
+ * @tc.type: FUNC
+ */
+HWTEST_F (DevicestatusManagerTest, ReactorTest001, TestSize.Level1)
+{
+    constexpr int64_t INTERVAL_NS = 1000000;
+    auto& reactor = DevicestatusReactor::GetInstance();
+    ASSERT_TRUE(reactor.Start());
+    std::promise<std::thread::id> ran;
+    DevicestatusReactor::Id deferred = reactor.AddTimer("test.deferred", [&ran, &reactor] {
+        EXPECT_TRUE(reactor.IsLoopThread());
+        ran.set_value(std::this_thread::get_id());
+    });
+    ASSERT_NE(deferred, DevicestatusReactor::INVALID_ID);
+    EXPECT_TRUE(reactor.ArmTimer(deferred, 0));
+    EXPECT_NE(ran.get_future().get(), std::this_thread::get_id());
+    reactor.Remove(deferred);
+
+    std::atomic<int32_t> ticks {0};
+    DevicestatusReactor::Id periodic = reactor.AddTimer("test.periodic", [&ticks] { ticks++; });
+    EXPECT_TRUE(reactor.ArmTimer(periodic, INTERVAL_NS, INTERVAL_NS));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    reactor.Remove(periodic);
+    int32_t removedAt = ticks.load();
+    EXPECT_GT(removedAt, 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_EQ(ticks.load(), removedAt);
+    EXPECT_FALSE(reactor.ArmTimer(periodic, 0));
+
+    std::string out;
+    reactor.Dump(out);
+    EXPECT_NE(out.find("test.periodic"), std::string::npos);
+}
+
+/**
+ * @tc.name: PollIntervalTest001
+ * @tc.desc: the poll interval drops on activity, backs off when idle and stays short while low latency is set
+ * @tc.type: FUNC
+ */
+HWTEST_F (DevicestatusManagerTest, PollIntervalTest001, TestSize.Level1)
+{
+    DevicestatusPollInterval interval;
+    EXPECT_EQ(interval.Reset(), DevicestatusPollInterval::DEFAULT_INTERVAL_MS);
+    EXPECT_EQ(interval.Next(true), DevicestatusPollInterval::MIN_INTERVAL_MS);
+    EXPECT_EQ(interval.Next(false), DevicestatusPollInterval::MIN_INTERVAL_MS * 2);
+    for (int32_t i = 0; i < 10; ++i) {
+        interval.Next(false);
+    }
+    EXPECT_EQ(interval.Get(), DevicestatusPollInterval::MAX_INTERVAL_MS);
+    EXPECT_TRUE(interval.SetLowLatency(true));
+    EXPECT_EQ(interval.Get(), DevicestatusPollInterval::MIN_INTERVAL_MS);
+    EXPECT_EQ(interval.Next(false), DevicestatusPollInterval::MIN_INTERVAL_MS);
+    EXPECT_FALSE(interval.SetLowLatency(false));
+    EXPECT_EQ(interval.Next(false), DevicestatusPollInterval::MIN_INTERVAL_MS * 2);
+}
+
+/**
+ * @tc.name: BackoffTest001
+ * @tc.desc: retry delays double up to the maximum, stay within the jittered step and start over after Reset
+ * @tc.type: FUNC
+ */
+HWTEST_F (DevicestatusManagerTest, BackoffTest001, TestSize.Level1)
+{
+    constexpr int64_t baseNs = 100;
+    constexpr int64_t maxNs = 1000;
+    DevicestatusBackoff backoff(baseNs, maxNs);
+    int64_t ceiling = baseNs;
+    for (int32_t i = 0; i < 8; ++i) {
+        int64_t delayNs = backoff.Next();
+        EXPECT_GE(delayNs, ceiling / 2);
+        EXPECT_LE(delayNs, ceiling);
+        ceiling = std::min(ceiling * 2, maxNs);
+    }
+    EXPECT_EQ(backoff.GetFailures(), 8u);
+    backoff.Reset();
+    EXPECT_LE(backoff.Next(), baseNs);
+}
+
+/**
+ * @tc.name: MailboxTest001
+ * @tc.desc: a subscriber mailbox coalesces per type, keeps first-queued order and counts what it drops
+ * @tc.type: FUNC
+ */
+HWTEST_F (DevicestatusManagerTest, MailboxTest001, TestSize.Level1)
+{
+    using Type = DevicestatusDataUtils::DevicestatusType;
+    using Value = DevicestatusDataUtils::DevicestatusValue;
+    sptr<RecordingCallback> callback = new RecordingCallback();
+    DevicestatusSubscriber subscriber(callback);
+    EXPECT_TRUE(subscriber.Push(MakeEvent(Type::TYPE_HIGH_STILL, Value::VALUE_ENTER, 1)));
+    EXPECT_FALSE(subscriber.Push(MakeEvent(Type::TYPE_FINE_STILL, Value::VALUE_ENTER, 1)));
+    EXPECT_FALSE(subscriber.Push(MakeEvent(Type::TYPE_HIGH_STILL, Value::VALUE_EXIT, 2)));
+    DevicestatusSubscriber::Stats stats = subscriber.GetStats();
+    EXPECT_EQ(stats.pending, 2u);
+    EXPECT_EQ(stats.coalesced, 1u);
+
+    EXPECT_FALSE(subscriber.Drain());
+    std::vector<DevicestatusDataUtils::DevicestatusData> events = callback->GetEvents();
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0].type, Type::TYPE_HIGH_STILL);
+    EXPECT_EQ(events[0].value, Value::VALUE_EXIT);
+    EXPECT_EQ(events[0].sequence, 2u);
+    EXPECT_EQ(events[1].type, Type::TYPE_FINE_STILL);
+    stats = subscriber.GetStats();
+    EXPECT_EQ(stats.delivered, 2u);
+    EXPECT_EQ(stats.pending, 0u);
+
+    // Drained, so the next event schedules the subscriber again; after Close() it is dropped.
+    EXPECT_TRUE(subscriber.Push(MakeEvent(Type::TYPE_HIGH_STILL, Value::VALUE_ENTER, 3)));
+    subscriber.Close();
+    EXPECT_FALSE(subscriber.Push(MakeEvent(Type::TYPE_HIGH_STILL, Value::VALUE_EXIT, 4)));
+    stats = subscriber.GetStats();
+    EXPECT_EQ(stats.dropped, 2u);
+    EXPECT_EQ(stats.pending, 0u);
+}
+
+/**
+ * @tc.name: RingDetachTest001
+ * @tc.desc: a subscriber goes back to binder once its event ring is detached and accepts a new ring afterwards
+ * @tc.type: FUNC
+ */
+HWTEST_F (DevicestatusManagerTest, RingDetachTest001, TestSize.Level1)
+{
+    using Type = DevicestatusDataUtils::DevicestatusType;
+    using Value = DevicestatusDataUtils::DevicestatusValue;
+    constexpr uint32_t capacity = DevicestatusEventRing::MIN_CAPACITY;
+    int32_t size = static_cast<int32_t>(DevicestatusEventRing::GetSize(capacity));
+    sptr<Ashmem> memory = Ashmem::CreateAshmem("devicestatus_ring_test", size);
+    ASSERT_NE(memory, nullptr);
+    ASSERT_TRUE(memory->MapReadAndWriteAshmem());
+    DevicestatusEventRing consumer;
+    ASSERT_TRUE(consumer.Create(const_cast<void*>(memory->ReadFromAshmem(size, 0)), size, capacity));
+
+    sptr<RecordingCallback> callback = new RecordingCallback();
+    DevicestatusSubscriber subscriber(callback);
+    EXPECT_TRUE(subscriber.AttachRing(memory, eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)));
+    EXPECT_FALSE(subscriber.AttachRing(memory, eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)));
+    EXPECT_TRUE(subscriber.Push(MakeEvent(Type::TYPE_HIGH_STILL, Value::VALUE_ENTER, 1)));
+    subscriber.Drain();
+    EXPECT_TRUE(callback->GetEvents().empty());
+
+    EXPECT_TRUE(subscriber.DetachRing());
+    EXPECT_FALSE(subscriber.HasRing());
+    EXPECT_TRUE(subscriber.Push(MakeEvent(Type::TYPE_HIGH_STILL, Value::VALUE_EXIT, 2)));
+    subscriber.Drain();
+    std::vector<DevicestatusDataUtils::DevicestatusData> events = callback->GetEvents();
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].sequence, 2u);
+    // What the service wrote before the detach is still there for the client.
+    DevicestatusDataUtils::DevicestatusData data;
+    ASSERT_TRUE(consumer.Pop(data));
+    EXPECT_EQ(data.sequence, 1u);
+
+    sptr<Ashmem> other = Ashmem::CreateAshmem("devicestatus_ring_test", size);
+    ASSERT_NE(other, nullptr);
+    ASSERT_TRUE(other->MapReadAndWriteAshmem());
+    ASSERT_TRUE(consumer.Create(const_cast<void*>(other->ReadFromAshmem(size, 0)), size, capacity));
+    EXPECT_TRUE(subscriber.AttachRing(other, eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)));
+    EXPECT_TRUE(subscriber.HasRing());
+    EXPECT_TRUE(subscriber.Push(MakeEvent(Type::TYPE_HIGH_STILL, Value::VALUE_ENTER, 3)));
+    subscriber.Drain();
+    ASSERT_TRUE(consumer.Pop(data));
+    EXPECT_EQ(data.sequence, 3u);
+    EXPECT_EQ(callback->GetEvents().size(), 1u);
+}
+
+/**
+ * @tc.name: DispatcherOrderTest001
+ * @tc.desc: events of one type reach a subscriber in dispatch order and the last one delivered is the newest
+ * @tc.type: FUNC
+ */
+HWTEST_F (DevicestatusManagerTest, DispatcherOrderTest001, TestSize.Level1)
+{
+    constexpr uint64_t eventCount = 20000;
+    sptr<RecordingCallback> callback = new RecordingCallback();
+    auto subscriber = std::make_shared<DevicestatusSubscriber>(callback);
+    DevicestatusDispatcher dispatcher;
+    ASSERT_TRUE(dispatcher.Start([&dispatcher, subscriber](const DevicestatusDataUtils::DevicestatusData& data) {
+        if (subscriber->Push(data)) {
+            dispatcher.Schedule(subscriber);
+        }
+    }, DevicestatusDispatcher::DEFAULT_WORKER_COUNT, eventCount));
+    for (uint64_t sequence = 1; sequence <= eventCount; ++sequence) {
+        using Value = DevicestatusDataUtils::DevicestatusValue;
+        Value value = ((sequence % 2) == 0) ? Value::VALUE_ENTER : Value::VALUE_EXIT;
+        dispatcher.Dispatch(MakeEvent(DevicestatusDataUtils::DevicestatusType::TYPE_LID_OPEN, value, sequence));
+    }
+    for (int32_t i = 0; i < DRAIN_WAIT_ROUNDS; ++i) {
+        if ((dispatcher.GetQueueDepth() == 0) && (subscriber->GetStats().pending == 0)) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(DRAIN_WAIT_MS));
+    }
+    dispatcher.Stop();
+
+    std::vector<DevicestatusDataUtils::DevicestatusData> events = callback->GetEvents();
+    ASSERT_FALSE(events.empty());
+    for (size_t i = 1; i < events.size(); ++i) {
+        EXPECT_GT(events[i].sequence, events[i - 1].sequence);
+    }
+    EXPECT_EQ(events.back().sequence, eventCount);
+}
+
+/**
+ * @tc.name: DispatcherCoalesceTest001
+ * @tc.desc: a burst of one type that overflows the dispatcher ring does not evict the last event of another type
+ * @tc.type: FUNC
+ */
+HWTEST_F (DevicestatusManagerTest, DispatcherCoalesceTest001, TestSize.Level1)
+{
+    using Type = DevicestatusDataUtils::DevicestatusType;
+    using Value = DevicestatusDataUtils::DevicestatusValue;
+    constexpr uint64_t burstCount = DevicestatusDispatcher::DEFAULT_QUEUE_CAPACITY * 4;
+    std::mutex mutex;
+    std::vector<DevicestatusDataUtils::DevicestatusData> events;
+    std::promise<void> entered;
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    DevicestatusDispatcher dispatcher;
+    ASSERT_TRUE(dispatcher.Start([&](const DevicestatusDataUtils::DevicestatusData& data) {
+        bool first = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            first = events.empty();
+            events.push_back(data);
+        }
+        if (first) {
+            // Hold the fan-out thread so that the burst below overflows the ring.
+            entered.set_value();
+            released.wait();
+        }
+    }));
+    dispatcher.Dispatch(MakeEvent(Type::TYPE_LID_OPEN, Value::VALUE_ENTER, 1));
+    entered.get_future().wait();
+    dispatcher.Dispatch(MakeEvent(Type::TYPE_HIGH_STILL, Value::VALUE_ENTER, 2));
+    for (uint64_t sequence = 3; sequence < burstCount + 3; ++sequence) {
+        Value value = ((sequence % 2) == 0) ? Value::VALUE_ENTER : Value::VALUE_EXIT;
+        dispatcher.Dispatch(MakeEvent(Type::TYPE_LID_OPEN, value, sequence));
+    }
+    EXPECT_GT(dispatcher.GetDroppedCount(), 0u);
+    release.set_value();
+    for (int32_t i = 0; (i < DRAIN_WAIT_ROUNDS) && (dispatcher.GetQueueDepth() != 0); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(DRAIN_WAIT_MS));
+    }
+    dispatcher.Stop();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto highStill = std::find_if(events.begin(), events.end(),
+        [](const DevicestatusDataUtils::DevicestatusData& data) { return data.type == Type::TYPE_HIGH_STILL; });
+    ASSERT_NE(highStill, events.end());
+    EXPECT_EQ(highStill->sequence, 2u);
+    EXPECT_EQ(events.back().type, Type::TYPE_LID_OPEN);
+    EXPECT_EQ(events.back().sequence, burstCount + 2);
+}
+
+/**
+ * @tc.name: RdbCursorTest001
+ * @tc.desc: the first read of a filled table returns only its newest row, later reads every newer row
+ * @tc.type: FUNC
+ */
+HWTEST_F (DevicestatusManagerTest, RdbCursorTest001, TestSize.Level1)
+{
+    std::shared_ptr<NativeRdb::RdbStore> store = CreateWriterStore(CURSOR_TEST_DATABASE);
+    ASSERT_NE(store, nullptr);
+    InsertRow(*store, "0", 1);
+    InsertRow(*store, "0", 0);
+    InsertRow(*store, "1", 1);
+
+    DevicestatusRdbCursor cursor;
+    std::vector<DevicestatusDataUtils::DevicestatusData> rows;
+    EXPECT_EQ(cursor.Read(*store, rows), ERR_OK);
+    ASSERT_EQ(rows.size(), 1u);
+    EXPECT_EQ(rows[0].type, DevicestatusDataUtils::DevicestatusType(1));
+    EXPECT_EQ(rows[0].value, DevicestatusDataUtils::DevicestatusValue(1));
+    EXPECT_GT(rows[0].timestamp, 0);
+    EXPECT_EQ(cursor.GetLastId(), 3);
+
+    InsertRow(*store, "0", 1);
+    InsertRow(*store, "1", 0);
+    rows.clear();
+    EXPECT_EQ(cursor.Read(*store, rows), ERR_OK);
+    ASSERT_EQ(rows.size(), 2u);
+    EXPECT_EQ(rows[0].type, DevicestatusDataUtils::DevicestatusType(0));
+    EXPECT_EQ(rows[1].type, DevicestatusDataUtils::DevicestatusType(1));
+    EXPECT_EQ(cursor.GetLastId(), 5);
+    NativeRdb::RdbHelper::DeleteRdbStore(CURSOR_TEST_DATABASE);
+}
+
+/**
+ * @tc.name: RdbCursorTest002
+ * @tc.desc: a cursor over an empty table starts at ID 0, so the first rows written are all new
+ * @tc.type: FUNC
+ */
+HWTEST_F (DevicestatusManagerTest, RdbCursorTest002, TestSize.Level1)
+{
+    std::shared_ptr<NativeRdb::RdbStore> store = CreateWriterStore(CURSOR_TEST_DATABASE);
+    ASSERT_NE(store, nullptr);
+    DevicestatusRdbCursor cursor;
+    EXPECT_EQ(cursor.GetLastId(), DevicestatusRdbCursor::INVALID_ID);
+    std::vector<DevicestatusDataUtils::DevicestatusData> rows;
+    EXPECT_EQ(cursor.Read(*store, rows), ERR_OK);
+    EXPECT_TRUE(rows.empty());
+    EXPECT_EQ(cursor.GetLastId(), 0);
+
+    InsertRow(*store, "0", 1);
+    InsertRow(*store, "0", 0);
+    EXPECT_EQ(cursor.Read(*store, rows), ERR_OK);
+    ASSERT_EQ(rows.size(), 2u);
+    EXPECT_EQ(rows[0].value, DevicestatusDataUtils::DevicestatusValue(1));
+    EXPECT_EQ(rows[1].value, DevicestatusDataUtils::DevicestatusValue(0));
+    EXPECT_EQ(cursor.GetLastId(), 2);
+    NativeRdb::RdbHelper::DeleteRdbStore(CURSOR_TEST_DATABASE);
+}
+
+/**
+ * @tc.name: RdbCursorTest003
+ * @tc.desc: one read returns every row written since the last one in ID order, also past BATCH_SIZE rows
+ * @tc.type: FUNC
+ */
+HWTEST_F (DevicestatusManagerTest, RdbCursorTest003, TestSize.Level1)
+{
+    constexpr int32_t rowCount = DevicestatusRdbCursor::BATCH_SIZE * 2 + 10;
+    std::shared_ptr<NativeRdb::RdbStore> store = CreateWriterStore(CURSOR_TEST_DATABASE);
+    ASSERT_NE(store, nullptr);
+    DevicestatusRdbCursor cursor;
+    std::vector<DevicestatusDataUtils::DevicestatusData> rows;
+    EXPECT_EQ(cursor.Read(*store, rows), ERR_OK);
+
+    for (int32_t i = 0; i < rowCount; ++i) {
+        InsertRow(*store, "0", i % 2);
+    }
+    EXPECT_EQ(cursor.Read(*store, rows), ERR_OK);
+    ASSERT_EQ(rows.size(), static_cast<size_t>(rowCount));
+    for (int32_t i = 0; i < rowCount; ++i) {
+        EXPECT_EQ(rows[i].value, DevicestatusDataUtils::DevicestatusValue(i % 2));
+    }
+    EXPECT_EQ(cursor.GetLastId(), rowCount);
+    EXPECT_EQ(cursor.GetRowCount(), static_cast<uint64_t>(rowCount));
+    NativeRdb::RdbHelper::DeleteRdbStore(CURSOR_TEST_DATABASE);
+}
+
+/**
+ * @tc.name: RdbCursorTest004
+ * @tc.desc: a row that cannot be decoded is skipped and the cursor still moves past it
+ * @tc.type: FUNC
+ */
+HWTEST_F (DevicestatusManagerTest, RdbCursorTest004, TestSize.Level1)
+{
+    std::shared_ptr<NativeRdb::RdbStore> store = CreateWriterStore(CURSOR_TEST_DATABASE);
+    ASSERT_NE(store, nullptr);
+    DevicestatusRdbCursor cursor;
+    std::vector<DevicestatusDataUtils::DevicestatusData> rows;
+    EXPECT_EQ(cursor.Read(*store, rows), ERR_OK);
+
+    InsertRow(*store, "0", 1);
+    // A blob does not convert to an integer.
+    InsertRow(*store, "X'00'", 1);
+    InsertRow(*store, "0", 0);
+    EXPECT_EQ(cursor.Read(*store, rows), ERR_OK);
+    ASSERT_EQ(rows.size(), 2u);
+    EXPECT_EQ(rows[0].value, DevicestatusDataUtils::DevicestatusValue(1));
+    EXPECT_EQ(rows[1].value, DevicestatusDataUtils::DevicestatusValue(0));
+    EXPECT_EQ(cursor.GetLastId(), 3);
+
+    rows.clear();
+    EXPECT_EQ(cursor.Read(*store, rows), ERR_OK);
+    EXPECT_TRUE(rows.empty());
+    EXPECT_EQ(cursor.GetLastId(), 3);
+    NativeRdb::RdbHelper::DeleteRdbStore(CURSOR_TEST_DATABASE);
+}
+
+/**
+ * @tc.name: MsdpRdbTest001
+ * @tc.desc: a burst of writes and NotifyDataChanged() calls is read once, rows written while disabled are
+ *           reported on the next Enable()
+ * @tc.type: FUNC
+ */
+HWTEST_F (DevicestatusManagerTest, MsdpRdbTest001, TestSize.Level1)
+{
+    mkdir(MSDP_RDB_TEST_DIR.c_str(), S_IRWXU);
+    std::shared_ptr<NativeRdb::RdbStore> store = CreateWriterStore(MSDP_RDB_TEST_DATABASE);
+    ASSERT_NE(store, nullptr);
+    InsertRow(*store, "0", 0);
+    InsertRow(*store, "0", 1);
+    auto callback = std::make_shared<RecordingAlgorithmCallback>();
+    auto rdb = std::make_unique<DevicestatusMsdpRdb>(MSDP_RDB_TEST_DIR);
+    rdb->RegisterCallback(callback);
+    rdb->Enable();
+    // Only the newest row of what was there before counts.
+    ASSERT_TRUE(WaitUntil([&callback] { return callback->GetResultCount() == 1; }));
+    EXPECT_NE(rdb->Dump().find("mode=push"), std::string::npos);
+
+    // Hold the reactor thread while the writer and NotifyDataChanged() fire, they all have to end up in one read.
+    auto& reactor = DevicestatusReactor::GetInstance();
+    std::promise<void> entered;
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    DevicestatusReactor::Id blocker = reactor.AddTimer("test.blocker", [&entered, released] {
+        entered.set_value();
+        released.wait();
+    });
+    ASSERT_TRUE(reactor.ArmTimer(blocker, 0));
+    entered.get_future().wait();
+    InsertRow(*store, "0", 0);
+    InsertRow(*store, "0", 0);
+    InsertRow(*store, "0", 1);
+    InsertRow(*store, "1", 1);
+    for (int32_t i = 0; i < DRAIN_WAIT_ROUNDS; ++i) {
+        rdb->NotifyDataChanged();
+    }
+    release.set_value();
+    ASSERT_TRUE(WaitUntil([&callback] { return callback->GetResultCount() == 4; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(DRAIN_WAIT_MS));
+    std::vector<std::vector<DevicestatusDataUtils::DevicestatusData>> batches = callback->GetBatches();
+    ASSERT_EQ(batches.size(), 2u);
+    // The repeated value is writer noise, the transitions keep their order.
+    ASSERT_EQ(batches[1].size(), 3u);
+    EXPECT_EQ(batches[1][0].value, DevicestatusDataUtils::DevicestatusValue(0));
+    EXPECT_EQ(batches[1][1].value, DevicestatusDataUtils::DevicestatusValue(1));
+    EXPECT_EQ(batches[1][2].type, DevicestatusDataUtils::DevicestatusType(1));
+    reactor.Remove(blocker);
+
+    rdb->Disable();
+    InsertRow(*store, "1", 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(DRAIN_WAIT_MS));
+    EXPECT_EQ(callback->GetResultCount(), 4u);
+    rdb->Enable();
+    ASSERT_TRUE(WaitUntil([&callback] { return callback->GetResultCount() == 5; }));
+    batches = callback->GetBatches();
+    EXPECT_EQ(batches.back().back().type, DevicestatusDataUtils::DevicestatusType(1));
+    EXPECT_EQ(batches.back().back().value, DevicestatusDataUtils::DevicestatusValue(0));
+
+    rdb = nullptr;
+    store = nullptr;
+    NativeRdb::RdbHelper::DeleteRdbStore(MSDP_RDB_TEST_DATABASE);
+    rmdir(MSDP_RDB_TEST_DIR.c_str());
+}
+
+/**
+ * @tc.name: MsdpRdbTest002
+ * @tc.desc: once the watch of the database directory is removed the plugin polls the database instead
+ * @tc.type: FUNC
+ */
+HWTEST_F (DevicestatusManagerTest, MsdpRdbTest002, TestSize.Level1)
+{
+    // No store: a reader holding a file in the directory open would keep the watch alive after rmdir().
+    NativeRdb::RdbHelper::DeleteRdbStore(MSDP_RDB_TEST_DATABASE);
+    mkdir(MSDP_RDB_TEST_DIR.c_str(), S_IRWXU);
+    auto rdb = std::make_unique<DevicestatusMsdpRdb>(MSDP_RDB_TEST_DIR);
+    rdb->Enable();
+    EXPECT_NE(rdb->Dump().find("mode=push"), std::string::npos);
+
+    // Removing the directory removes the watch with it, inotify reports IN_IGNORED.
+    ASSERT_EQ(rmdir(MSDP_RDB_TEST_DIR.c_str()), 0);
+    ASSERT_TRUE(WaitUntil([&rdb] { return rdb->Dump().find("mode=poll") != std::string::npos; }));
+    std::string interval = "timerInterval=" + std::to_string(DevicestatusPollInterval::DEFAULT_INTERVAL_MS) + "ms";
+    EXPECT_NE(rdb->Dump().find(interval), std::string::npos);
+
+    rdb->Disable();
+    EXPECT_NE(rdb->Dump().find("timerInterval=0ms"), std::string::npos);
+}
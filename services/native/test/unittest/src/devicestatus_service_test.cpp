@@ -107,3 +107,93 @@ HWTEST_F (DevicestatusServiceTest, GetDevicestatusDataTest003, TestSize.Level0)
     EXPECT_EQ(true, data.type == DevicestatusDataUtils::DevicestatusType::TYPE_CAR_BLUETOOTH && \
         data.value == DevicestatusDataUtils::DevicestatusValue::VALUE_INVALID) << "GetDevicestatusData failed";
 }
+
+/**
+ * @tc.name: DevicestatusSubscribeTypesTest001
+ * @tc.desc: test subscribing and unsubscribing several types in one transaction
+ * @tc.type: FUNC
+ */
+HWTEST_F (DevicestatusServiceTest, DevicestatusSubscribeTypesTest001, TestSize.Level0)
+{
+    auto& devicestatusClient = DevicestatusClient::GetInstance();
+    sptr<IdevicestatusCallback> cb = new DevicestatusServiceTestCallback();
+    DevicestatusTypeTable<int32_t> results(E_DEVICESTATUS_INNER_ERR);
+    EXPECT_EQ(ERR_OK, devicestatusClient.SubscribeCallback(DEVICESTATUS_TYPE_MASK_ALL, cb, results));
+    for (const auto& result : results) {
+        EXPECT_EQ(ERR_OK, result);
+    }
+    results.Fill(E_DEVICESTATUS_INNER_ERR);
+    uint32_t typeMask = DevicestatusTypeMask(DevicestatusDataUtils::DevicestatusType::TYPE_HIGH_STILL);
+    EXPECT_EQ(ERR_OK, devicestatusClient.UnSubscribeCallback(typeMask, cb, results));
+    EXPECT_EQ(ERR_OK, results[DevicestatusDataUtils::DevicestatusType::TYPE_HIGH_STILL]);
+    EXPECT_EQ(E_DEVICESTATUS_INNER_ERR, results[DevicestatusDataUtils::DevicestatusType::TYPE_LID_OPEN]);
+    EXPECT_EQ(ERR_OK, devicestatusClient.UnSubscribeCallback(typeMask, cb, results));
+    EXPECT_EQ(E_DEVICESTATUS_NOT_SUBSCRIBED, results[DevicestatusDataUtils::DevicestatusType::TYPE_HIGH_STILL]);
+    EXPECT_EQ(ERR_OK, devicestatusClient.UnSubscribeCallback(DEVICESTATUS_TYPE_MASK_ALL & ~typeMask, cb, results));
+}
+
+/**
+ * @tc.name: GetAllDevicestatusDataTest001
+ * @tc.desc: test getting the state of every type in one transaction
+ * @tc.type: FUNC
+ */
+HWTEST_F (DevicestatusServiceTest, GetAllDevicestatusDataTest001, TestSize.Level0)
+{
+    auto& devicestatusClient = DevicestatusClient::GetInstance();
+    DevicestatusTypeTable<DevicestatusLatestState::Entry> entries;
+    EXPECT_EQ(ERR_OK, devicestatusClient.GetAllDevicestatusData(entries));
+    for (size_t i = 0; i < DEVICESTATUS_TYPE_COUNT; ++i) {
+        const auto& entry = entries[DevicestatusTypeTable<int32_t>::TypeAt(i)];
+        GTEST_LOG_(INFO) << DEVICESTATUS_TYPE_NAMES[i] << " value: " << entry.value << ", version: " << entry.sequence;
+        if (entry.sequence == 0) {
+            EXPECT_EQ(DevicestatusDataUtils::DevicestatusValue::VALUE_INVALID, entry.value);
+        }
+    }
+}
+
+/**
+ * @tc.name: DevicestatusMultiplexTest001
+ * @tc.desc: test that local listeners of one type share the remote subscription
+ * @tc.type: FUNC
+ */
+HWTEST_F (DevicestatusServiceTest, DevicestatusMultiplexTest001, TestSize.Level0)
+{
+    auto& devicestatusClient = DevicestatusClient::GetInstance();
+    DevicestatusDataUtils::DevicestatusType type = DevicestatusDataUtils::DevicestatusType::TYPE_LID_OPEN;
+    uint32_t typeMask = DevicestatusTypeMask(type);
+    sptr<IdevicestatusCallback> first = new DevicestatusServiceTestCallback();
+    sptr<IdevicestatusCallback> second = new DevicestatusServiceTestCallback();
+    DevicestatusTypeTable<int32_t> results(E_DEVICESTATUS_INNER_ERR);
+    EXPECT_EQ(ERR_OK, devicestatusClient.SubscribeCallback(typeMask, first, results));
+    EXPECT_EQ(ERR_OK, results[type]);
+    EXPECT_EQ(ERR_OK, devicestatusClient.SubscribeCallback(typeMask, second, results));
+    EXPECT_EQ(ERR_OK, results[type]);
+    EXPECT_EQ(ERR_OK, devicestatusClient.UnSubscribeCallback(typeMask, first, results));
+    EXPECT_EQ(ERR_OK, results[type]);
+    EXPECT_EQ(ERR_OK, devicestatusClient.UnSubscribeCallback(typeMask, first, results));
+    EXPECT_EQ(E_DEVICESTATUS_NOT_SUBSCRIBED, results[type]);
+    EXPECT_EQ(ERR_OK, devicestatusClient.UnSubscribeCallback(typeMask, second, results));
+    EXPECT_EQ(ERR_OK, results[type]);
+}
+
+/**
+ * @tc.name: DevicestatusStateMirrorTest001
+ * @tc.desc: test that a mirrored type is read from process memory and matches the service state
+ * @tc.type: FUNC
+ */
+HWTEST_F (DevicestatusServiceTest, DevicestatusStateMirrorTest001, TestSize.Level0)
+{
+    auto& devicestatusClient = DevicestatusClient::GetInstance();
+    DevicestatusDataUtils::DevicestatusType type = DevicestatusDataUtils::DevicestatusType::TYPE_LID_OPEN;
+    DevicestatusStateMirror::Entry entry;
+    EXPECT_FALSE(devicestatusClient.ReadMirroredState(type, entry));
+    EXPECT_EQ(ERR_OK, devicestatusClient.EnableStateMirror(DevicestatusTypeMask(type)));
+    ASSERT_TRUE(devicestatusClient.ReadMirroredState(type, entry));
+    EXPECT_GT(entry.updateTime, 0);
+    DevicestatusDataUtils::DevicestatusData data = devicestatusClient.GetDevicestatusData(type);
+    EXPECT_EQ(type, data.type);
+    EXPECT_EQ(entry.value, data.value);
+    EXPECT_EQ(entry.sequence, data.sequence);
+    devicestatusClient.DisableStateMirror();
+    EXPECT_FALSE(devicestatusClient.ReadMirroredState(type, entry));
+}
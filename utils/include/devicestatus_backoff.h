@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DEVICESTATUS_BACKOFF_H
+#define DEVICESTATUS_BACKOFF_H
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+
+namespace OHOS {
+namespace Msdp {
+/*
+ * Delays between the attempts of an operation that keeps failing. The ceiling starts at baseNs and doubles
+ * with every failure up to maxNs; the delay is drawn from the upper half of the ceiling, so that sources
+ * failing for the same reason do not retry in lockstep while none waits less than half a step. Not thread
+ * safe, the owner uses it from one thread.
+ */
+class DevicestatusBackoff {
+public:
+    DevicestatusBackoff(int64_t baseNs, int64_t maxNs) : baseNs_(baseNs), maxNs_(std::max(baseNs, maxNs)) {}
+
+    // Delay before the next attempt, counting the attempt that just failed.
+    int64_t Next()
+    {
+        int64_t ceiling = baseNs_;
+        for (uint32_t i = 0; (i < failures_) && (ceiling < maxNs_); ++i) {
+            ceiling *= 2;
+        }
+        ceiling = std::min(ceiling, maxNs_);
+        ++failures_;
+        std::uniform_int_distribution<int64_t> jitter(ceiling / 2, ceiling);
+        return jitter(random_);
+    }
+
+    // Called once the operation succeeds; the next failure starts over at baseNs.
+    void Reset()
+    {
+        failures_ = 0;
+    }
+
+    uint32_t GetFailures() const
+    {
+        return failures_;
+    }
+
+private:
+    const int64_t baseNs_;
+    const int64_t maxNs_;
+    uint32_t failures_ = 0;
+    std::minstd_rand random_ { std::random_device {}() };
+};
+} // namespace Msdp
+} // namespace OHOS
+#endif // DEVICESTATUS_BACKOFF_H
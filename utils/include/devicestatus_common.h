@@ -17,6 +17,7 @@
 #define DEVICESTATUS_COMMON_H
 
 #include <cstdint>
+#include <ctime>
 #include <type_traits>
 
 #include "devicestatus_hilog_wrapper.h"
@@ -71,6 +72,15 @@ constexpr auto DevicestatusToUnderlying(E e) noexcept
 {
     return static_cast<std::underlying_type_t<E>>(e);
 }
+
+// Nanoseconds since boot, including time spent in suspend.
+inline int64_t DevicestatusGetBootTime()
+{
+    constexpr int64_t NS_PER_SECOND = 1000000000;
+    struct timespec ts = {0, 0};
+    clock_gettime(CLOCK_BOOTTIME, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * NS_PER_SECOND + ts.tv_nsec;
+}
 } // namespace Msdp
 } // namespace OHOS
 
@@ -40,7 +40,9 @@ enum {
     E_DEVICESTATUS_GET_SYSTEM_ABILITY_MANAGER_FAILED,
     E_DEVICESTATUS_GET_SERVICE_FAILED,
     E_DEVICESTATUS_ADD_DEATH_RECIPIENT_FAILED,
-    E_DEVICESTATUS_INNER_ERR
+    E_DEVICESTATUS_INNER_ERR,
+    E_DEVICESTATUS_INVALID_TYPE,
+    E_DEVICESTATUS_NOT_SUBSCRIBED
 };
 } // namespace Msdp
 } // namespace OHOS
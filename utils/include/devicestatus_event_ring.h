@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DEVICESTATUS_EVENT_RING_H
+#define DEVICESTATUS_EVENT_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#include "devicestatus_data_utils.h"
+
+namespace OHOS {
+namespace Msdp {
+/*
+ * Single-producer single-consumer ring of DevicestatusData laid out in memory shared between the service
+ * (producer) and one client (consumer). The client formats the memory with Create() and the service checks
+ * it with Attach(); afterwards each side keeps its own copy of the capacity, so neither trusts the other to
+ * keep the header intact. The head and tail are free running counters, a slot is head % capacity.
+ */
+class DevicestatusEventRing {
+public:
+    static constexpr uint32_t MAGIC = 0x44535247;
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t MIN_CAPACITY = 16;
+    static constexpr uint32_t MAX_CAPACITY = 4096;
+    static constexpr uint32_t DEFAULT_CAPACITY = 64;
+
+    static constexpr bool IsValidCapacity(uint32_t capacity)
+    {
+        return (capacity >= MIN_CAPACITY) && (capacity <= MAX_CAPACITY) && ((capacity & (capacity - 1)) == 0);
+    }
+
+    static constexpr size_t GetSize(uint32_t capacity)
+    {
+        return sizeof(Header) + sizeof(Slot) * capacity;
+    }
+
+    // Formats size bytes at base as an empty ring; used by the consumer that owns the memory.
+    bool Create(void* base, size_t size, uint32_t capacity)
+    {
+        if ((base == nullptr) || !IsValidCapacity(capacity) || (size < GetSize(capacity))) {
+            return false;
+        }
+        Header* header = new (base) Header;
+        header->magic = MAGIC;
+        header->version = VERSION;
+        header->capacity = capacity;
+        Bind(header, capacity);
+        return true;
+    }
+
+    // Maps a ring formatted by the consumer; fails when the header does not describe memory of this size.
+    bool Attach(void* base, size_t size)
+    {
+        if ((base == nullptr) || (size < sizeof(Header))) {
+            return false;
+        }
+        Header* header = static_cast<Header*>(base);
+        uint32_t capacity = header->capacity;
+        if ((header->magic != MAGIC) || (header->version != VERSION) || !IsValidCapacity(capacity) ||
+            (size < GetSize(capacity))) {
+            return false;
+        }
+        Bind(header, capacity);
+        return true;
+    }
+
+    bool IsValid() const
+    {
+        return header_ != nullptr;
+    }
+
+    // Producer side. Returns false when the ring is full; wasEmpty tells whether the consumer may be asleep.
+    bool Push(const DevicestatusDataUtils::DevicestatusData& data, bool& wasEmpty)
+    {
+        uint64_t head = header_->head.load(std::memory_order_relaxed);
+        if ((head - header_->tail.load(std::memory_order_acquire)) >= capacity_) {
+            return false;
+        }
+        Slot& slot = slots_[head & (capacity_ - 1)];
+        slot.type = data.type;
+        slot.value = data.value;
+        slot.timestamp = data.timestamp;
+        slot.sequence = data.sequence;
+        slot.sourceId = data.sourceId;
+        // Publish first, then look at the tail. The consumer stores the tail and then loads the head (Pop), all
+        // sequentially consistent, so either it sees this entry or this load sees that it has caught up.
+        header_->head.store(head + 1);
+        wasEmpty = (header_->tail.load() == head);
+        return true;
+    }
+
+    // Consumer side. Returns false when the ring is empty; the consumer may only sleep after a Pop() failed.
+    bool Pop(DevicestatusDataUtils::DevicestatusData& data)
+    {
+        uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+        uint64_t head = header_->head.load();
+        if ((head == tail) || ((head - tail) > capacity_)) {
+            return false;
+        }
+        const Slot& slot = slots_[tail & (capacity_ - 1)];
+        data.type = static_cast<DevicestatusDataUtils::DevicestatusType>(slot.type);
+        data.value = static_cast<DevicestatusDataUtils::DevicestatusValue>(slot.value);
+        data.timestamp = slot.timestamp;
+        data.sequence = slot.sequence;
+        data.sourceId = slot.sourceId;
+        header_->tail.store(tail + 1);
+        return true;
+    }
+
+private:
+    struct Slot {
+        int32_t type;
+        int32_t value;
+        int64_t timestamp;
+        uint64_t sequence;
+        int32_t sourceId;
+        int32_t reserved;
+    };
+    // Head and tail live on separate cache lines, each written by one side only.
+    struct Header {
+        uint32_t magic = 0;
+        uint32_t version = 0;
+        uint32_t capacity = 0;
+        alignas(64) std::atomic<uint64_t> head {0};
+        alignas(64) std::atomic<uint64_t> tail {0};
+    };
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "ring indices must be lock-free across processes");
+
+    void Bind(Header* header, uint32_t capacity)
+    {
+        header_ = header;
+        slots_ = reinterpret_cast<Slot*>(reinterpret_cast<uint8_t*>(header) + sizeof(Header));
+        capacity_ = capacity;
+    }
+
+    Header* header_ = nullptr;
+    Slot* slots_ = nullptr;
+    uint32_t capacity_ = 0;
+};
+} // namespace Msdp
+} // namespace OHOS
+#endif // DEVICESTATUS_EVENT_RING_H
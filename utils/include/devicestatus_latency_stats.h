@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DEVICESTATUS_LATENCY_STATS_H
+#define DEVICESTATUS_LATENCY_STATS_H
+
+#include <array>
+#include <atomic>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "devicestatus_common.h"
+#include "devicestatus_data_utils.h"
+#include "devicestatus_type_table.h"
+
+namespace OHOS {
+namespace Msdp {
+/*
+ * Log-linear histogram of nanosecond durations. Every power of two is split into SUB_BUCKET_COUNT linear
+ * buckets, so a percentile is reported with at most 1/SUB_BUCKET_COUNT relative error. Recording is a
+ * handful of relaxed atomic increments and never blocks; reading is a scan and may observe a recording
+ * that is only partly applied, which is fine for monitoring.
+ */
+class DevicestatusLatencyHistogram {
+public:
+    static constexpr uint32_t SUB_BUCKET_BITS = 3;
+    static constexpr uint64_t SUB_BUCKET_COUNT = 1ULL << SUB_BUCKET_BITS;
+    static constexpr size_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+    void Record(int64_t ns)
+    {
+        uint64_t value = (ns > 0) ? static_cast<uint64_t>(ns) : 0;
+        buckets_[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        uint64_t max = max_.load(std::memory_order_relaxed);
+        while ((value > max) && !max_.compare_exchange_weak(max, value, std::memory_order_relaxed)) {}
+    }
+
+    uint64_t GetCount() const
+    {
+        return count_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t GetMax() const
+    {
+        return max_.load(std::memory_order_relaxed);
+    }
+
+    // Upper bound of the bucket holding the given fraction of the samples, 0 when empty.
+    uint64_t GetPercentile(double fraction) const
+    {
+        uint64_t total = 0;
+        for (const auto& bucket : buckets_) {
+            total += bucket.load(std::memory_order_relaxed);
+        }
+        if (total == 0) {
+            return 0;
+        }
+        uint64_t rank = static_cast<uint64_t>(fraction * static_cast<double>(total));
+        if (rank >= total) {
+            rank = total - 1;
+        }
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            seen += buckets_[i].load(std::memory_order_relaxed);
+            if (seen > rank) {
+                uint64_t bound = BucketUpperBound(i);
+                uint64_t max = GetMax();
+                return (bound < max) ? bound : max;
+            }
+        }
+        return GetMax();
+    }
+
+    void Reset()
+    {
+        for (auto& bucket : buckets_) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        count_.store(0, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static size_t BucketIndex(uint64_t value)
+    {
+        if (value < SUB_BUCKET_COUNT) {
+            return static_cast<size_t>(value);
+        }
+        uint32_t shift = static_cast<uint32_t>(63 - __builtin_clzll(value)) - SUB_BUCKET_BITS;
+        uint64_t sub = (value >> shift) & (SUB_BUCKET_COUNT - 1);
+        return static_cast<size_t>((shift + 1) * SUB_BUCKET_COUNT + sub);
+    }
+
+    static uint64_t BucketUpperBound(size_t index)
+    {
+        if (index < SUB_BUCKET_COUNT) {
+            return index;
+        }
+        uint64_t shift = index / SUB_BUCKET_COUNT - 1;
+        uint64_t lower = (SUB_BUCKET_COUNT + index % SUB_BUCKET_COUNT) << shift;
+        return lower + (1ULL << shift) - 1;
+    }
+
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets_ {};
+    std::atomic<uint64_t> count_ {0};
+    std::atomic<uint64_t> max_ {0};
+};
+
+/*
+ * Latency of every hop an event takes inside the service, from the source that observed it up to the
+ * callback transaction to the client, kept per hop and per type and reported by the service dump. Hops are
+ * measured against DevicestatusData::timestamp, so they are cumulative from the observation; events without
+ * a timestamp are not recorded.
+ */
+class DevicestatusLatencyStats {
+public:
+    enum Hop {
+        HOP_SOURCE_TO_IMPL = 0,
+        HOP_SOURCE_TO_NOTIFY,
+        HOP_SOURCE_TO_DELIVER,
+        HOP_CALLBACK_TRANSACT,
+        HOP_COUNT,
+    };
+
+    static DevicestatusLatencyStats& GetInstance()
+    {
+        static DevicestatusLatencyStats instance;
+        return instance;
+    }
+
+    // Records the time elapsed since the event was observed by its source.
+    void RecordSince(Hop hop, const DevicestatusDataUtils::DevicestatusData& data)
+    {
+        if (data.timestamp <= 0) {
+            return;
+        }
+        Record(hop, data.type, DevicestatusGetBootTime() - data.timestamp);
+    }
+
+    void Record(Hop hop, DevicestatusDataUtils::DevicestatusType type, int64_t ns)
+    {
+        if ((hop < 0) || (hop >= HOP_COUNT)) {
+            return;
+        }
+        DevicestatusLatencyHistogram* histogram = histograms_[hop].Find(type);
+        if (histogram != nullptr) {
+            histogram->Record(ns);
+        }
+    }
+
+    const DevicestatusLatencyHistogram& Get(Hop hop, DevicestatusDataUtils::DevicestatusType type) const
+    {
+        return histograms_[hop][type];
+    }
+
+    // One line per hop and type that has samples: "hop type count p50 p99 p999 max", in microseconds.
+    std::string Dump() const
+    {
+        constexpr double NS_PER_US = 1000.0;
+        std::string out;
+        char line[LINE_SIZE];
+        for (size_t hop = 0; hop < HOP_COUNT; ++hop) {
+            for (size_t i = 0; i < DEVICESTATUS_TYPE_COUNT; ++i) {
+                const auto& histogram = histograms_[hop][DevicestatusTypeTable<int32_t>::TypeAt(i)];
+                uint64_t count = histogram.GetCount();
+                if (count == 0) {
+                    continue;
+                }
+                int32_t len = snprintf(line, sizeof(line),
+                    "%-16s %-14s count=%" PRIu64 " p50=%.1fus p99=%.1fus p999=%.1fus max=%.1fus\n",
+                    HOP_NAMES[hop], DEVICESTATUS_TYPE_NAMES[i], count,
+                    histogram.GetPercentile(0.5) / NS_PER_US, histogram.GetPercentile(0.99) / NS_PER_US,
+                    histogram.GetPercentile(0.999) / NS_PER_US, histogram.GetMax() / NS_PER_US);
+                if (len > 0) {
+                    out.append(line);
+                }
+            }
+        }
+        return out;
+    }
+
+    void Reset()
+    {
+        for (auto& table : histograms_) {
+            for (auto& histogram : table) {
+                histogram.Reset();
+            }
+        }
+    }
+
+private:
+    static constexpr size_t LINE_SIZE = 160;
+    static constexpr std::array<const char*, HOP_COUNT> HOP_NAMES = {
+        "source->impl",
+        "source->notify",
+        "source->deliver",
+        "callback",
+    };
+
+    DevicestatusLatencyStats() = default;
+    std::array<DevicestatusTypeTable<DevicestatusLatencyHistogram>, HOP_COUNT> histograms_;
+};
+} // namespace Msdp
+} // namespace OHOS
+#endif // DEVICESTATUS_LATENCY_STATS_H
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DEVICESTATUS_LATEST_STATE_H
+#define DEVICESTATUS_LATEST_STATE_H
+
+#include <atomic>
+#include <cstdint>
+
+#include "devicestatus_data_utils.h"
+#include "devicestatus_type_table.h"
+
+namespace OHOS {
+namespace Msdp {
+/*
+ * Latest value of every DevicestatusType, kept in one seqlock per type. Writers update a slot in place and
+ * readers copy it out without taking a lock or allocating, retrying only while a write to the same type is
+ * in progress. The sequence number of an entry counts the updates of its type, 0 means never reported.
+ */
+class DevicestatusLatestState {
+public:
+    struct Entry {
+        DevicestatusDataUtils::DevicestatusValue value = DevicestatusDataUtils::DevicestatusValue::VALUE_INVALID;
+        int64_t timestamp = 0;
+        uint64_t sequence = 0;
+    };
+
+    // Returns the sequence number of the new entry, or 0 when the type is invalid.
+    uint64_t Update(DevicestatusDataUtils::DevicestatusType type, DevicestatusDataUtils::DevicestatusValue value,
+        int64_t timestamp)
+    {
+        Slot* slot = slots_.Find(type);
+        if (slot == nullptr) {
+            return 0;
+        }
+        // Writers of the same type serialize on the odd sequence value, writers of other types never meet.
+        uint64_t seq = slot->seq.load(std::memory_order_relaxed);
+        do {
+            while ((seq & 1) != 0) {
+                seq = slot->seq.load(std::memory_order_relaxed);
+            }
+        } while (!slot->seq.compare_exchange_weak(seq, seq + 1, std::memory_order_relaxed));
+        std::atomic_thread_fence(std::memory_order_release);
+        slot->value.store(value, std::memory_order_relaxed);
+        slot->timestamp.store(timestamp, std::memory_order_relaxed);
+        slot->seq.store(seq + 2, std::memory_order_release);
+        return (seq + 2) >> 1;
+    }
+
+    // Returns false when the type is invalid; an entry with sequence 0 has never been reported.
+    bool Read(DevicestatusDataUtils::DevicestatusType type, Entry& entry) const
+    {
+        const Slot* slot = slots_.Find(type);
+        if (slot == nullptr) {
+            return false;
+        }
+        while (true) {
+            uint64_t begin = slot->seq.load(std::memory_order_acquire);
+            if ((begin & 1) != 0) {
+                continue;
+            }
+            entry.value = slot->value.load(std::memory_order_relaxed);
+            entry.timestamp = slot->timestamp.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot->seq.load(std::memory_order_relaxed) == begin) {
+                entry.sequence = begin >> 1;
+                return true;
+            }
+        }
+    }
+
+private:
+    // One cache line per type so that readers of one type are not invalidated by writes to another.
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> seq {0};
+        std::atomic<DevicestatusDataUtils::DevicestatusValue> value {
+            DevicestatusDataUtils::DevicestatusValue::VALUE_INVALID
+        };
+        std::atomic<int64_t> timestamp {0};
+    };
+    DevicestatusTypeTable<Slot> slots_;
+};
+} // namespace Msdp
+} // namespace OHOS
+#endif // DEVICESTATUS_LATEST_STATE_H
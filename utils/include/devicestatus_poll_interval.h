@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DEVICESTATUS_POLL_INTERVAL_H
+#define DEVICESTATUS_POLL_INTERVAL_H
+
+#include <algorithm>
+#include <cstdint>
+
+namespace OHOS {
+namespace Msdp {
+/*
+ * Interval of a source that has to be polled. A poll that finds transitions brings the next one down to
+ * MIN_INTERVAL_MS, every idle poll doubles the interval up to MAX_INTERVAL_MS. While a latency sensitive
+ * subscriber needs the source the interval never grows past the minimum. Not thread safe, the owner keeps
+ * it under the same lock as the timer it arms.
+ */
+class DevicestatusPollInterval {
+public:
+    static constexpr int32_t MIN_INTERVAL_MS = 500;
+    static constexpr int32_t DEFAULT_INTERVAL_MS = 3000;
+    static constexpr int32_t MAX_INTERVAL_MS = 30000;
+
+    // Interval of the first poll after polling (re)starts.
+    int32_t Reset()
+    {
+        current_ = Cap(DEFAULT_INTERVAL_MS);
+        return current_;
+    }
+
+    // Interval until the next poll, given whether the poll that just ran found any transition.
+    int32_t Next(bool active)
+    {
+        current_ = active ? MIN_INTERVAL_MS : Cap(current_ * 2);
+        return current_;
+    }
+
+    // Returns true when the current interval got shorter, so that the pending poll has to be brought forward.
+    bool SetLowLatency(bool lowLatency)
+    {
+        lowLatency_ = lowLatency;
+        int32_t capped = Cap(current_);
+        bool shorter = capped < current_;
+        current_ = capped;
+        return shorter;
+    }
+
+    int32_t Get() const
+    {
+        return current_;
+    }
+
+    bool IsLowLatency() const
+    {
+        return lowLatency_;
+    }
+
+private:
+    int32_t Cap(int32_t intervalMs) const
+    {
+        return std::min(intervalMs, lowLatency_ ? MIN_INTERVAL_MS : MAX_INTERVAL_MS);
+    }
+
+    int32_t current_ = DEFAULT_INTERVAL_MS;
+    bool lowLatency_ = false;
+};
+} // namespace Msdp
+} // namespace OHOS
+#endif // DEVICESTATUS_POLL_INTERVAL_H
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DEVICESTATUS_REACTOR_H
+#define DEVICESTATUS_REACTOR_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <nocopyable.h>
+
+namespace OHOS {
+namespace Msdp {
+/*
+ * The one event loop thread of the service process. The service and the plugins it loads register file
+ * descriptors and timers with it instead of running threads of their own. Registrations can be added and
+ * removed at any time from any thread; once Remove() returns, the callback is not running and will not
+ * run again, unless Remove() was called from the callback itself. A timer armed with no delay is how work
+ * is deferred to the loop thread. All timers share one timerfd on CLOCK_BOOTTIME, so they keep counting
+ * through suspend; they do not wake the device, a timer that came due while suspended runs on resume.
+ *
+ * The time spent in callbacks is accounted per registration name and shown by Dump().
+ */
+class DevicestatusReactor {
+public:
+    using Id = uint64_t;
+    using Task = std::function<void()>;
+    using FdHandler = std::function<void(uint32_t events)>;
+    static constexpr Id INVALID_ID = 0;
+
+    static DevicestatusReactor& GetInstance();
+
+    // Start() may be called by every user, the loop thread is only created once. Stop() joins it.
+    bool Start();
+    void Stop();
+    bool IsRunning() const
+    {
+        return running_.load();
+    }
+    bool IsLoopThread() const
+    {
+        return std::this_thread::get_id() == loopThreadId_.load();
+    }
+
+    // handler gets the epoll events of fd, fd is watched for EPOLLIN.
+    Id AddFd(int32_t fd, const std::string& name, const FdHandler& handler);
+    // The timer is created disarmed.
+    Id AddTimer(const std::string& name, const Task& task);
+    // Fires after delayNs and then every intervalNs, or once when intervalNs is 0. Rearming replaces the old
+    // deadline.
+    bool ArmTimer(Id id, int64_t delayNs, int64_t intervalNs = 0);
+    void DisarmTimer(Id id);
+    void Remove(Id id);
+    void Dump(std::string& out);
+
+private:
+    struct Entry {
+        std::string name;
+        int32_t fd = -1;
+        FdHandler fdHandler;
+        Task task;
+        // Boot time the timer fires at, 0 when disarmed.
+        int64_t deadline = 0;
+        int64_t interval = 0;
+    };
+    struct Stats {
+        uint64_t runs = 0;
+        uint64_t totalNs = 0;
+        uint64_t maxNs = 0;
+    };
+
+    DevicestatusReactor();
+    ~DevicestatusReactor();
+    DISALLOW_COPY_AND_MOVE(DevicestatusReactor);
+
+    void LoopEntry();
+    void RunDueTimers();
+    void Run(Id id, const std::shared_ptr<Entry>& entry, uint32_t events);
+    void ScheduleLocked(Id id, Entry& entry, int64_t deadline);
+    void UnscheduleLocked(Id id, Entry& entry);
+    void ArmTimerFdLocked();
+    void Wake();
+
+    std::mutex mutex_;
+    // Signalled whenever a callback returns, Remove() waits on it for the callback it removes.
+    std::condition_variable idleCond_;
+    std::map<Id, std::shared_ptr<Entry>> entries_;
+    std::multimap<int64_t, Id> timers_;
+    std::map<std::string, Stats> stats_;
+    Id nextId_ = INVALID_ID + 1;
+    Id runningId_ = INVALID_ID;
+    int64_t armedDeadline_ = 0;
+    uint64_t loops_ = 0;
+    int32_t epFd_ = -1;
+    int32_t timerFd_ = -1;
+    int32_t wakeFd_ = -1;
+    std::atomic<bool> running_ {false};
+    std::thread thread_;
+    std::atomic<std::thread::id> loopThreadId_ {};
+};
+} // namespace Msdp
+} // namespace OHOS
+#endif // DEVICESTATUS_REACTOR_H
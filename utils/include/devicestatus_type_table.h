@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DEVICESTATUS_TYPE_TABLE_H
+#define DEVICESTATUS_TYPE_TABLE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "devicestatus_data_utils.h"
+
+namespace OHOS {
+namespace Msdp {
+constexpr size_t DEVICESTATUS_TYPE_COUNT = DevicestatusDataUtils::DevicestatusType::TYPE_LID_OPEN + 1;
+
+constexpr std::array<const char*, DEVICESTATUS_TYPE_COUNT> DEVICESTATUS_TYPE_NAMES = {
+    "HIGH_STILL",
+    "FINE_STILL",
+    "CAR_BLUETOOTH",
+    "LID_OPEN",
+};
+
+constexpr bool IsValidDevicestatusType(DevicestatusDataUtils::DevicestatusType type)
+{
+    return (type >= 0) && (static_cast<size_t>(type) < DEVICESTATUS_TYPE_COUNT);
+}
+
+constexpr const char* GetDevicestatusTypeName(DevicestatusDataUtils::DevicestatusType type)
+{
+    return IsValidDevicestatusType(type) ? DEVICESTATUS_TYPE_NAMES[type] : "INVALID";
+}
+
+// Bit of a type in the type masks used by the multi-type interface codes.
+constexpr uint32_t DevicestatusTypeMask(DevicestatusDataUtils::DevicestatusType type)
+{
+    return IsValidDevicestatusType(type) ? (1u << static_cast<uint32_t>(type)) : 0;
+}
+
+constexpr uint32_t DEVICESTATUS_TYPE_MASK_ALL = (1u << DEVICESTATUS_TYPE_COUNT) - 1;
+
+/*
+ * Fixed size table with one slot per DevicestatusType, indexed directly by the enum value. Lookups are a
+ * bounds check plus an array access and the table never allocates, so it can be used on the event path in
+ * place of std::map<DevicestatusType, T>.
+ */
+template<typename T>
+class DevicestatusTypeTable {
+public:
+    using Type = DevicestatusDataUtils::DevicestatusType;
+    static constexpr size_t SIZE = DEVICESTATUS_TYPE_COUNT;
+
+    constexpr DevicestatusTypeTable() = default;
+    explicit DevicestatusTypeTable(const T& value)
+    {
+        items_.fill(value);
+    }
+
+    // Callers must pass a valid type; use Find() for values that come from outside the process.
+    T& operator[](Type type)
+    {
+        return items_[static_cast<size_t>(type)];
+    }
+    const T& operator[](Type type) const
+    {
+        return items_[static_cast<size_t>(type)];
+    }
+
+    T* Find(Type type)
+    {
+        return IsValidDevicestatusType(type) ? &items_[static_cast<size_t>(type)] : nullptr;
+    }
+    const T* Find(Type type) const
+    {
+        return IsValidDevicestatusType(type) ? &items_[static_cast<size_t>(type)] : nullptr;
+    }
+
+    void Fill(const T& value)
+    {
+        items_.fill(value);
+    }
+
+    static constexpr Type TypeAt(size_t index)
+    {
+        return static_cast<Type>(index);
+    }
+
+    constexpr size_t size() const
+    {
+        return SIZE;
+    }
+    typename std::array<T, SIZE>::iterator begin()
+    {
+        return items_.begin();
+    }
+    typename std::array<T, SIZE>::iterator end()
+    {
+        return items_.end();
+    }
+    typename std::array<T, SIZE>::const_iterator begin() const
+    {
+        return items_.begin();
+    }
+    typename std::array<T, SIZE>::const_iterator end() const
+    {
+        return items_.end();
+    }
+
+private:
+    std::array<T, SIZE> items_ {};
+};
+} // namespace Msdp
+} // namespace OHOS
+#endif // DEVICESTATUS_TYPE_TABLE_H
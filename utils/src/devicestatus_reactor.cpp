@@ -0,0 +1,356 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "devicestatus_reactor.h"
+
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include "devicestatus_common.h"
+
+namespace OHOS {
+namespace Msdp {
+namespace {
+// epoll tags of the reactor's own fds, registrations count up from 1 and never get here.
+constexpr DevicestatusReactor::Id TIMER_FD_TAG = UINT64_MAX;
+constexpr DevicestatusReactor::Id WAKE_FD_TAG = UINT64_MAX - 1;
+constexpr int32_t MAX_EVENTS = 16;
+constexpr int64_t NS_PER_SECOND = 1000000000;
+constexpr uint64_t NS_PER_US = 1000;
+constexpr size_t DUMP_LINE_SIZE = 128;
+
+bool AddToEpoll(int32_t epFd, int32_t fd, uint64_t tag)
+{
+    struct epoll_event ev = {};
+    ev.events = EPOLLIN | EPOLLWAKEUP;
+    ev.data.u64 = tag;
+    if (epoll_ctl(epFd, EPOLL_CTL_ADD, fd, &ev) == -1) {
+        DEV_HILOGE(SERVICE, "epoll_ctl add %{public}d failed, errno: %{public}d", fd, errno);
+        return false;
+    }
+    return true;
+}
+
+void DrainFd(int32_t fd)
+{
+    uint64_t count = 0;
+    if ((read(fd, &count, sizeof(count)) == -1) && (errno != EAGAIN)) {
+        DEV_HILOGE(SERVICE, "read %{public}d failed, errno: %{public}d", fd, errno);
+    }
+}
+}
+
+DevicestatusReactor& DevicestatusReactor::GetInstance()
+{
+    static DevicestatusReactor instance;
+    return instance;
+}
+
+DevicestatusReactor::DevicestatusReactor()
+{
+    epFd_ = epoll_create1(EPOLL_CLOEXEC);
+    timerFd_ = timerfd_create(CLOCK_BOOTTIME, TFD_NONBLOCK | TFD_CLOEXEC);
+    wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if ((epFd_ == -1) || (timerFd_ == -1) || (wakeFd_ == -1) || !AddToEpoll(epFd_, timerFd_, TIMER_FD_TAG) ||
+        !AddToEpoll(epFd_, wakeFd_, WAKE_FD_TAG)) {
+        DEV_HILOGE(SERVICE, "create reactor fds failed, errno: %{public}d", errno);
+    }
+}
+
+DevicestatusReactor::~DevicestatusReactor()
+{
+    Stop();
+    for (int32_t fd : { epFd_, timerFd_, wakeFd_ }) {
+        if (fd != -1) {
+            close(fd);
+        }
+    }
+}
+
+bool DevicestatusReactor::Start()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_.load()) {
+        return true;
+    }
+    if ((epFd_ == -1) || (timerFd_ == -1) || (wakeFd_ == -1)) {
+        DEV_HILOGE(SERVICE, "reactor fds are not ready");
+        return false;
+    }
+    DEV_HILOGI(SERVICE, "Enter");
+    running_.store(true);
+    thread_ = std::thread(&DevicestatusReactor::LoopEntry, this);
+    return true;
+}
+
+void DevicestatusReactor::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_.exchange(false)) {
+            return;
+        }
+        if (!entries_.empty()) {
+            DEV_HILOGW(SERVICE, "stopped with %{public}zu registrations left", entries_.size());
+        }
+    }
+    DEV_HILOGI(SERVICE, "Enter");
+    Wake();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+DevicestatusReactor::Id DevicestatusReactor::AddFd(int32_t fd, const std::string& name, const FdHandler& handler)
+{
+    if ((fd < 0) || (handler == nullptr)) {
+        DEV_HILOGE(SERVICE, "invalid fd registration: %{public}s", name.c_str());
+        return INVALID_ID;
+    }
+    auto entry = std::make_shared<Entry>();
+    entry->name = name;
+    entry->fd = fd;
+    entry->fdHandler = handler;
+    std::lock_guard<std::mutex> lock(mutex_);
+    Id id = nextId_++;
+    if (!AddToEpoll(epFd_, fd, id)) {
+        return INVALID_ID;
+    }
+    entries_.emplace(id, entry);
+    return id;
+}
+
+DevicestatusReactor::Id DevicestatusReactor::AddTimer(const std::string& name, const Task& task)
+{
+    if (task == nullptr) {
+        DEV_HILOGE(SERVICE, "invalid timer registration: %{public}s", name.c_str());
+        return INVALID_ID;
+    }
+    auto entry = std::make_shared<Entry>();
+    entry->name = name;
+    entry->task = task;
+    std::lock_guard<std::mutex> lock(mutex_);
+    Id id = nextId_++;
+    entries_.emplace(id, entry);
+    return id;
+}
+
+bool DevicestatusReactor::ArmTimer(Id id, int64_t delayNs, int64_t intervalNs)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = entries_.find(id);
+    if ((iter == entries_.end()) || (iter->second->task == nullptr)) {
+        DEV_HILOGE(SERVICE, "no timer %{public}" PRIu64, id);
+        return false;
+    }
+    Entry& entry = *iter->second;
+    UnscheduleLocked(id, entry);
+    entry.interval = (intervalNs > 0) ? intervalNs : 0;
+    ScheduleLocked(id, entry, DevicestatusGetBootTime() + ((delayNs > 0) ? delayNs : 0));
+    ArmTimerFdLocked();
+    return true;
+}
+
+void DevicestatusReactor::DisarmTimer(Id id)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = entries_.find(id);
+    if (iter != entries_.end()) {
+        UnscheduleLocked(id, *iter->second);
+        ArmTimerFdLocked();
+    }
+}
+
+void DevicestatusReactor::Remove(Id id)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto iter = entries_.find(id);
+    if (iter == entries_.end()) {
+        return;
+    }
+    Entry& entry = *iter->second;
+    if ((entry.fd != -1) && (epoll_ctl(epFd_, EPOLL_CTL_DEL, entry.fd, nullptr) == -1)) {
+        DEV_HILOGE(SERVICE, "epoll_ctl del %{public}d failed, errno: %{public}d", entry.fd, errno);
+    }
+    UnscheduleLocked(id, entry);
+    entries_.erase(iter);
+    ArmTimerFdLocked();
+    if (!IsLoopThread()) {
+        idleCond_.wait(lock, [this, id] { return runningId_ != id; });
+    }
+}
+
+void DevicestatusReactor::Dump(std::string& out)
+{
+    char line[DUMP_LINE_SIZE];
+    std::lock_guard<std::mutex> lock(mutex_);
+    int32_t len = snprintf(line, sizeof(line), "reactor: running=%s registrations=%zu timers=%zu loops=%" PRIu64 "\n",
+        running_.load() ? "yes" : "no", entries_.size(), timers_.size(), loops_);
+    if (len > 0) {
+        out.append(line);
+    }
+    for (const auto& [name, stats] : stats_) {
+        len = snprintf(line, sizeof(line), "  %-24s runs=%" PRIu64 " total=%" PRIu64 "us max=%" PRIu64 "us\n",
+            name.c_str(), stats.runs, stats.totalNs / NS_PER_US, stats.maxNs / NS_PER_US);
+        if (len > 0) {
+            out.append(line);
+        }
+    }
+}
+
+void DevicestatusReactor::LoopEntry()
+{
+    loopThreadId_.store(std::this_thread::get_id());
+    struct epoll_event events[MAX_EVENTS];
+    while (running_.load()) {
+        int32_t count = epoll_wait(epFd_, events, MAX_EVENTS, -1);
+        if (count == -1) {
+            if (errno != EINTR) {
+                DEV_HILOGE(SERVICE, "epoll_wait failed, errno: %{public}d", errno);
+            }
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            loops_++;
+        }
+        for (int32_t i = 0; i < count; ++i) {
+            Id id = events[i].data.u64;
+            if (id == TIMER_FD_TAG) {
+                DrainFd(timerFd_);
+                continue;
+            }
+            if (id == WAKE_FD_TAG) {
+                DrainFd(wakeFd_);
+                continue;
+            }
+            std::shared_ptr<Entry> entry;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto iter = entries_.find(id);
+                if (iter == entries_.end()) {
+                    // Removed by an earlier callback of this round.
+                    continue;
+                }
+                entry = iter->second;
+                runningId_ = id;
+            }
+            Run(id, entry, events[i].events);
+        }
+        RunDueTimers();
+    }
+    loopThreadId_.store(std::thread::id());
+}
+
+void DevicestatusReactor::RunDueTimers()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    int64_t now = DevicestatusGetBootTime();
+    while (!timers_.empty() && (timers_.begin()->first <= now)) {
+        Id id = timers_.begin()->second;
+        timers_.erase(timers_.begin());
+        auto iter = entries_.find(id);
+        if (iter == entries_.end()) {
+            continue;
+        }
+        std::shared_ptr<Entry> entry = iter->second;
+        int64_t deadline = entry->deadline;
+        entry->deadline = 0;
+        if (entry->interval > 0) {
+            // A late periodic timer fires once and keeps its period from now on, it does not catch up.
+            int64_t next = deadline + entry->interval;
+            ScheduleLocked(id, *entry, (next > now) ? next : (now + entry->interval));
+        }
+        runningId_ = id;
+        lock.unlock();
+        Run(id, entry, 0);
+        lock.lock();
+        now = DevicestatusGetBootTime();
+    }
+    ArmTimerFdLocked();
+}
+
+void DevicestatusReactor::Run(Id id, const std::shared_ptr<Entry>& entry, uint32_t events)
+{
+    int64_t start = DevicestatusGetBootTime();
+    if (entry->fdHandler != nullptr) {
+        entry->fdHandler(events);
+    } else {
+        entry->task();
+    }
+    uint64_t elapsed = static_cast<uint64_t>(DevicestatusGetBootTime() - start);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Stats& stats = stats_[entry->name];
+        stats.runs++;
+        stats.totalNs += elapsed;
+        stats.maxNs = (elapsed > stats.maxNs) ? elapsed : stats.maxNs;
+        runningId_ = INVALID_ID;
+    }
+    idleCond_.notify_all();
+}
+
+void DevicestatusReactor::ScheduleLocked(Id id, Entry& entry, int64_t deadline)
+{
+    entry.deadline = deadline;
+    timers_.emplace(deadline, id);
+}
+
+void DevicestatusReactor::UnscheduleLocked(Id id, Entry& entry)
+{
+    if (entry.deadline == 0) {
+        return;
+    }
+    auto range = timers_.equal_range(entry.deadline);
+    for (auto iter = range.first; iter != range.second; ++iter) {
+        if (iter->second == id) {
+            timers_.erase(iter);
+            break;
+        }
+    }
+    entry.deadline = 0;
+}
+
+void DevicestatusReactor::ArmTimerFdLocked()
+{
+    int64_t deadline = timers_.empty() ? 0 : timers_.begin()->first;
+    if (deadline == armedDeadline_) {
+        return;
+    }
+    struct itimerspec spec = {};
+    spec.it_value.tv_sec = deadline / NS_PER_SECOND;
+    spec.it_value.tv_nsec = deadline % NS_PER_SECOND;
+    // An absolute deadline that has already passed fires at once; all zeros disarms.
+    if (timerfd_settime(timerFd_, TFD_TIMER_ABSTIME, &spec, nullptr) == -1) {
+        DEV_HILOGE(SERVICE, "timerfd_settime failed, errno: %{public}d", errno);
+        return;
+    }
+    armedDeadline_ = deadline;
+}
+
+void DevicestatusReactor::Wake()
+{
+    uint64_t one = 1;
+    if (write(wakeFd_, &one, sizeof(one)) == -1) {
+        DEV_HILOGE(SERVICE, "wake reactor failed, errno: %{public}d", errno);
+    }
+}
+} // namespace Msdp
+} // namespace OHOS